@@ -14,7 +14,8 @@
 #ifndef BITARRAY_H
 #define BITARRAY_H
 
-#include <stddef.h> /* CHAR_BIT */
+#include <limits.h> /* CHAR_BIT */
+#include <stddef.h> /* size_t */
 #include <string.h> /* memset */
 
 /** @private Number of bits in an unsigned int. */
@@ -26,7 +27,7 @@
  * @param bit The bit.
  * @return Its mask.
  */
-#define bitArray_mask(bit) (1 << ((bit) % BITARRAY_INTBITS))
+#define bitArray_mask(bit) (1u << ((bit) % BITARRAY_INTBITS))
 
 /**
  * Slot for a bit: the index in the array.
@@ -157,6 +158,6 @@
  * @return void.
  */
 #define bitArray_zeroe(ar, sz)                                                  \
-		memset(ar, 0, bitArray_size(sz))
+		memset(ar, 0, bitArray_size(sz) * sizeof *(ar))
 
 #endif /* BITARRAY_H */
@@ -0,0 +1,157 @@
+/**
+ * LiquidMem: columns of values in chunks of rivers.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidcolumn.c
+ *
+ * See README.md for quick-start info and liquidcolumn.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquidmem.h"
+#include "liquidcolumn.h"
+
+/* Add a chunk for chunkLength more values. */
+static char * addChunk(memcolumn_s * col){
+	if(col->chunkCount == col->chunkCapacity){
+		size_t capacity = col->chunkCapacity ? col->chunkCapacity * 2 : 16;
+		char ** chunks = realloc(col->chunks, capacity * sizeof *chunks);
+		if(!chunks){
+			return NULL;
+		}
+		col->chunks = chunks;
+		col->chunkCapacity = capacity;
+	}
+	
+	char * chunk = memriver_alloc_aligned(col->river, 
+			col->chunkLength * col->width, MEMCOLUMN_ALIGN);
+	if(!chunk){
+		return NULL;
+	}
+	
+	return col->chunks[col->chunkCount++] = chunk;
+}
+
+memcolumn_s * memcolumn_init(memcolumn_s * col, memriver_s * riv,
+		size_t width){
+	col->length = 0;
+	col->width = width;
+	col->chunkCount = 0;
+	col->chunkCapacity = 0;
+	col->chunks = NULL;
+	col->river = riv;
+	
+	// leave room to align the chunk within a creek
+	size_t room = riv->creekSize > MEMCOLUMN_ALIGN ?
+			riv->creekSize - MEMCOLUMN_ALIGN : 0;
+	col->chunkLength = room / width ? room / width : 1;
+	
+	return col;
+}
+
+memcolumn_s * memcolumn_clear(memcolumn_s * col){
+	free(col->chunks);
+	col->chunks = NULL;
+	col->chunkCount = 0;
+	col->chunkCapacity = 0;
+	col->length = 0;
+	
+	return col;
+}
+
+void * memcolumn_push(memcolumn_s * col){
+	size_t offset = col->length % col->chunkLength;
+	
+	if(col->length == col->chunkCount * col->chunkLength && !addChunk(col)){
+		return NULL;
+	}
+	
+	col->length++;
+	
+	return col->chunks[col->chunkCount - 1] + offset * col->width;
+}
+
+memcolumn_s * memcolumn_append(memcolumn_s * col, const void * vsrc,
+		size_t n){
+	const char * src = vsrc;
+	
+	while(n){
+		if(col->length == col->chunkCount * col->chunkLength &&
+				!addChunk(col)){
+			return NULL;
+		}
+		
+		// fill up the last chunk as far as possible
+		size_t offset = col->length % col->chunkLength;
+		size_t count = col->chunkLength - offset;
+		if(count > n){
+			count = n;
+		}
+		
+		memcpy(col->chunks[col->chunkCount - 1] + offset * col->width, src,
+				count * col->width);
+		col->length += count;
+		src += count * col->width;
+		n -= count;
+	}
+	
+	return col;
+}
+
+void * memcolumn_at(memcolumn_s * col, size_t i){
+	return col->chunks[i / col->chunkLength] + 
+			i % col->chunkLength * col->width;
+}
+
+void * memcolumn_span(memcolumn_s * col, size_t chunk, size_t * length){
+	size_t start = chunk * col->chunkLength;
+	size_t left = col->length - start;
+	
+	*length = left < col->chunkLength ? left : col->chunkLength;
+	
+	return col->chunks[chunk];
+}
+
+void * memcolumn_copy(memcolumn_s * col, size_t i, size_t n, void * vdst){
+	char * dst = vdst;
+	
+	while(n){
+		size_t offset = i % col->chunkLength;
+		size_t count = col->chunkLength - offset;
+		if(count > n){
+			count = n;
+		}
+		
+		memcpy(dst, memcolumn_at(col, i), count * col->width);
+		dst += count * col->width;
+		i += count;
+		n -= count;
+	}
+	
+	return vdst;
+}
@@ -0,0 +1,140 @@
+/**
+ * LiquidMem: columns of values in chunks of rivers.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidcolumn.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDCOLUMN_H
+#define LIQUIDCOLUMN_H
+
+#include "liquidmem.h"
+
+/** The alignment of the chunks of a column. */
+#define MEMCOLUMN_ALIGN 64
+
+/**
+ * A column appends values of fixed width into chunks allocated from a river.
+ * All chunks but the last hold the same number of values, which are never 
+ * moved, so each chunk can be scanned as a plain, aligned array. Several
+ * columns may share one river.
+ *
+ * Strings can be stored as a column of end offsets next to a column of bytes:
+ * string i spans bytes ends[i - 1] to ends[i], and memcolumn_copy reads them
+ * back.
+ */
+typedef struct memcolumn{
+	/** The number of values. */
+	size_t length;
+	/** The width of the values. */
+	size_t width;
+	/** The number of values per chunk. */
+	size_t chunkLength;
+	/** The number of chunks. */
+	size_t chunkCount;
+	/** The number of chunks there is room for in chunks. */
+	size_t chunkCapacity;
+	
+	/** The chunks. */
+	char ** chunks;
+	/** The river to allocate from. */
+	memriver_s * river;
+} memcolumn_s;
+
+/**
+ * Get a value of a column as the given type.
+ *
+ * @param col The column.
+ * @param type The type of the values.
+ * @param i The index of the value.
+ * @return The value (an lvalue).
+ */
+#define memcolumn_get(col, type, i) (*(type *)memcolumn_at(col, i))
+
+/**
+ * Initialize a column. The chunks are sized to fit in the river's creeks.
+ *
+ * @param col The column to initialize.
+ * @param riv The river to allocate from.
+ * @param width The width of the values.
+ * @return col.
+ */
+memcolumn_s * memcolumn_init(memcolumn_s * col, memriver_s * riv,
+		size_t width);
+/**
+ * De-initialize a column. The chunks remain in the river until it is reset.
+ *
+ * @param col The column to clear.
+ * @return col.
+ */
+memcolumn_s * memcolumn_clear(memcolumn_s * col);
+/**
+ * Append a value to a column.
+ *
+ * @param col The column.
+ * @return A pointer to the new (uninitialized) value, or NULL on error.
+ */
+void * memcolumn_push(memcolumn_s * col);
+/**
+ * Copy n values to the end of a column.
+ *
+ * @param col The column.
+ * @param src The values to copy.
+ * @param n The number of values.
+ * @return col, or NULL on error.
+ */
+memcolumn_s * memcolumn_append(memcolumn_s * col, const void * src, size_t n);
+/**
+ * Get a value of a column.
+ *
+ * @param col The column.
+ * @param i The index of the value, less than the column's length.
+ * @return A pointer to the value.
+ */
+void * memcolumn_at(memcolumn_s * col, size_t i);
+/**
+ * Get a chunk of a column, to scan its values.
+ *
+ * @param col The column.
+ * @param chunk The index of the chunk, less than the column's chunkCount.
+ * @param length Set to the number of values in the chunk.
+ * @return The chunk's values.
+ */
+void * memcolumn_span(memcolumn_s * col, size_t chunk, size_t * length);
+/**
+ * Copy n values of a column, which may span several chunks.
+ *
+ * @param col The column.
+ * @param i The index of the first value.
+ * @param n The number of values, i + n should be at most the column's length.
+ * @param dst Where to copy the values to.
+ * @return dst.
+ */
+void * memcolumn_copy(memcolumn_s * col, size_t i, size_t n, void * dst);
+
+#endif /* LIQUIDCOLUMN_H */
@@ -0,0 +1,138 @@
+/**
+ * LiquidMem: generational rivers that promote survivors.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidgen.c
+ *
+ * See README.md for quick-start info and liquidgen.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+
+#include "liquidmem.h"
+#include "liquidgen.h"
+
+memgen_s * memgen_init(memgen_s * gen, size_t nurserySize, size_t oldSize){
+	gen->survivors = NULL;
+	gen->lastSurvivor = NULL;
+	
+	if(!memriver_init(&gen->nursery, nurserySize)){
+		return NULL;
+	}
+	if(!memriver_init(&gen->old, oldSize)){
+		memriver_clear(&gen->nursery);
+		return NULL;
+	}
+	
+	return gen;
+}
+
+memgen_s * memgen_make(size_t nurserySize, size_t oldSize){
+	memgen_s * ret = malloc(sizeof *ret);
+	
+	if(!ret){
+		return NULL;
+	}
+	
+	return memgen_init(ret, nurserySize, oldSize);
+}
+
+memgen_s * memgen_reset(memgen_s * gen){
+	gen->survivors = NULL;
+	gen->lastSurvivor = NULL;
+	
+	if(!memriver_reset(&gen->nursery) || !memriver_reset(&gen->old)){
+		return NULL;
+	}
+	
+	return gen;
+}
+
+memgen_s * memgen_clear(memgen_s * gen){
+	gen->survivors = NULL;
+	gen->lastSurvivor = NULL;
+	
+	memriver_clear(&gen->nursery);
+	memriver_clear(&gen->old);
+	
+	return gen;
+}
+
+void memgen_free(memgen_s * gen){
+	memgen_clear(gen);
+	free(gen);
+}
+
+void * memgen_alloc(memgen_s * gen, size_t size){
+	return memriver_alloc(&gen->nursery, size);
+}
+
+void * memgen_promote(memgen_s * gen, const void * ptr, size_t size){
+	return memriver_memdup(&gen->old, ptr, size);
+}
+
+memgen_s * memgen_keep(memgen_s * gen, void ** ref, size_t size){
+	memsurvivor_s * surv = memriver_alloc_aligned(&gen->nursery, sizeof *surv,
+			sizeof(void *));
+	if(!surv){
+		return NULL;
+	}
+	
+	surv->next = NULL;
+	surv->ref = ref;
+	surv->size = size;
+	
+	if(gen->lastSurvivor){
+		gen->lastSurvivor->next = surv;
+	}else{
+		gen->survivors = surv;
+	}
+	gen->lastSurvivor = surv;
+	
+	return gen;
+}
+
+memgen_s * memgen_cycle(memgen_s * gen){
+	for(; gen->survivors; gen->survivors = gen->survivors->next){
+		memsurvivor_s * surv = gen->survivors;
+		if(!*surv->ref){
+			continue;
+		}
+		
+		void * copy = memgen_promote(gen, *surv->ref, surv->size);
+		if(!copy){
+			return NULL;
+		}
+		*surv->ref = copy;
+	}
+	gen->lastSurvivor = NULL;
+	
+	if(!memriver_reset(&gen->nursery)){
+		return NULL;
+	}
+	
+	return gen;
+}
@@ -0,0 +1,148 @@
+/**
+ * LiquidMem: generational rivers that promote survivors.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidgen.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDGEN_H
+#define LIQUIDGEN_H
+
+#include "liquidmem.h"
+
+/**
+ * A request to copy an object into the old generation at the next cycle.
+ * Survivors are allocated in the nursery, so they go when it is reset.
+ */
+typedef struct memsurvivor{
+	/** The next survivor, in the order they were kept. */
+	struct memsurvivor * next;
+	/** Where the pointer to the object is stored. */
+	void ** ref;
+	/** The size of the object. */
+	size_t size;
+} memsurvivor_s;
+
+/**
+ * A generational river allocates from a nursery river that is reset at every 
+ * cycle. Objects that must outlive a cycle are copied into an old river, 
+ * either right away with memgen_promote or at the next cycle with memgen_keep.
+ */
+typedef struct memgen{
+	/** The river of new objects. */
+	memriver_s nursery;
+	/** The river of promoted objects. */
+	memriver_s old;
+	
+	/** The first survivor of the current cycle. */
+	memsurvivor_s * survivors;
+	/** The last survivor of the current cycle. */
+	memsurvivor_s * lastSurvivor;
+} memgen_s;
+
+/**
+ * Initialize a generational river.
+ *
+ * @param gen The generational river to initialize.
+ * @param nurserySize The size of the nursery's creeks.
+ * @param oldSize The size of the old river's creeks.
+ * @return gen if successful, NULL on error.
+ */
+memgen_s * memgen_init(memgen_s * gen, size_t nurserySize, size_t oldSize);
+/**
+ * Malloc and initialize a generational river.
+ *
+ * @param nurserySize The size of the nursery's creeks.
+ * @param oldSize The size of the old river's creeks.
+ * @return An initialized generational river, or NULL on error.
+ */
+memgen_s * memgen_make(size_t nurserySize, size_t oldSize);
+/**
+ * Reset a generational river: release all objects, old ones included.
+ *
+ * @param gen The generational river to reset.
+ * @return gen, or NULL on error.
+ */
+memgen_s * memgen_reset(memgen_s * gen);
+/**
+ * De-initialize a generational river: release all objects and invalidate the
+ * storage.
+ *
+ * @param gen The generational river to clear.
+ * @return gen.
+ */
+memgen_s * memgen_clear(memgen_s * gen);
+/**
+ * Clear and free a generational river that was made with memgen_make.
+ *
+ * @param gen The generational river to free, must have been obtained with 
+ *            memgen_make.
+ */
+void memgen_free(memgen_s * gen);
+/**
+ * Allocate a new object in the nursery. It is released at the next cycle, 
+ * unless it is kept.
+ *
+ * @param gen The generational river to allocate from.
+ * @param size The size of the object.
+ * @return A pointer to the object, or NULL on error.
+ */
+void * memgen_alloc(memgen_s * gen, size_t size);
+/**
+ * Copy an object into the old generation now.
+ *
+ * @param gen The generational river.
+ * @param ptr The object.
+ * @param size The size of the object.
+ * @return The copy, or NULL on error.
+ */
+void * memgen_promote(memgen_s * gen, const void * ptr, size_t size);
+/**
+ * Keep an object alive past the next cycle: at the cycle, the object *ref 
+ * points to is copied into the old generation and *ref is pointed to the copy.
+ * *ref is only read at the cycle (and skipped if it is NULL by then), so ref
+ * must stay valid until then and must not lie in the nursery itself. To keep
+ * objects that point to each other, promote them and fix their pointers.
+ *
+ * @param gen The generational river.
+ * @param ref Where the pointer to the object is stored.
+ * @param size The size of the object.
+ * @return gen, or NULL on error.
+ */
+memgen_s * memgen_keep(memgen_s * gen, void ** ref, size_t size);
+/**
+ * End a cycle: promote the kept objects and reset the nursery.
+ *
+ * @param gen The generational river.
+ * @return gen, or NULL if an object couldn't be promoted. In that case the
+ *         nursery is not reset, the objects not yet promoted are still kept,
+ *         and the cycle can be retried.
+ */
+memgen_s * memgen_cycle(memgen_s * gen);
+
+#endif /* LIQUIDGEN_H */
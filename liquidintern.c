@@ -0,0 +1,202 @@
+/**
+ * LiquidMem: string interning in rivers.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidintern.c
+ *
+ * See README.md for quick-start info and liquidintern.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "liquidmem.h"
+#include "liquidmap.h"
+#include "liquidintern.h"
+
+/** The initial number of buckets. */
+#define INITIAL_SIZE 64
+
+/* Find the bucket of a string, or the empty bucket where it would go. */
+static uint32_t * findBucket(memintern_s * in, const char * str, size_t length,
+		uint64_t hash){
+	size_t mask = in->size - 1;
+	
+	for(size_t i = (size_t)hash & mask; ; i = (i + 1) & mask){
+		uint32_t * bucket = in->buckets + i;
+		if(!*bucket){
+			return bucket;
+		}
+		
+		memstring_s * s = in->strings + *bucket - 1;
+		if(s->hash == hash && s->length == length &&
+				!memcmp(s->str, str, length)){
+			return bucket;
+		}
+	}
+}
+
+/* Double the buckets and re-insert all strings. */
+static memintern_s * grow(memintern_s * in){
+	size_t size = in->size * 2;
+	uint32_t * buckets = calloc(size, sizeof *buckets);
+	if(!buckets){
+		return NULL;
+	}
+	
+	free(in->buckets);
+	in->buckets = buckets;
+	in->size = size;
+	
+	for(size_t id = 0; id < in->length; id++){
+		memstring_s * s = in->strings + id;
+		*findBucket(in, s->str, s->length, s->hash) = (uint32_t)(id + 1);
+	}
+	
+	return in;
+}
+
+memintern_s * memintern_init(memintern_s * in, size_t creekSize){
+	in->length = 0;
+	in->capacity = 0;
+	in->size = INITIAL_SIZE;
+	in->strings = NULL;
+	
+	in->buckets = calloc(in->size, sizeof *in->buckets);
+	if(!in->buckets){
+		return NULL;
+	}
+	
+	if(!memriver_init(&in->river, creekSize)){
+		return NULL;
+	}
+	
+	return in;
+}
+
+memintern_s * memintern_make(size_t creekSize){
+	memintern_s * ret = malloc(sizeof *ret);
+	if(!ret){
+		return NULL;
+	}
+	
+	return memintern_init(ret, creekSize);
+}
+
+memintern_s * memintern_reset(memintern_s * in){
+	memset(in->buckets, 0, in->size * sizeof *in->buckets);
+	in->length = 0;
+	
+	if(!memriver_recycle(&in->river, 0)){
+		return NULL;
+	}
+	
+	return in;
+}
+
+memintern_s * memintern_clear(memintern_s * in){
+	memriver_clear(&in->river);
+	free(in->buckets);
+	free(in->strings);
+	
+	in->buckets = NULL;
+	in->strings = NULL;
+	in->length = 0;
+	in->capacity = 0;
+	in->size = 0;
+	
+	return in;
+}
+
+void memintern_free(memintern_s * in){
+	memintern_clear(in);
+	free(in);
+}
+
+size_t memintern_add(memintern_s * in, const char * str, size_t length){
+	uint64_t hash = memmap_hash(str, length);
+	uint32_t * bucket = findBucket(in, str, length, hash);
+	if(*bucket){
+		return *bucket - 1;
+	}
+	
+	if(in->length >= UINT32_MAX){
+		return MEMINTERN_NONE;
+	}
+	
+	// keep the buckets at most half full
+	if((in->length + 1) * 2 > in->size){
+		if(!grow(in)){
+			return MEMINTERN_NONE;
+		}
+		bucket = findBucket(in, str, length, hash);
+	}
+	
+	if(in->length == in->capacity){
+		size_t capacity = in->capacity ? in->capacity * 2 : INITIAL_SIZE;
+		memstring_s * strs = realloc(in->strings, capacity * sizeof *strs);
+		if(!strs){
+			return MEMINTERN_NONE;
+		}
+		in->strings = strs;
+		in->capacity = capacity;
+	}
+	
+	char * copy = memriver_alloc(&in->river, length + 1);
+	if(!copy){
+		return MEMINTERN_NONE;
+	}
+	memcpy(copy, str, length);
+	copy[length] = '\0';
+	
+	size_t id = in->length++;
+	in->strings[id].str = copy;
+	in->strings[id].length = length;
+	in->strings[id].hash = hash;
+	*bucket = (uint32_t)(id + 1);
+	
+	return id;
+}
+
+size_t memintern_find(memintern_s * in, const char * str, size_t length){
+	uint32_t * bucket = findBucket(in, str, length, memmap_hash(str, length));
+	
+	return *bucket ? *bucket - 1 : MEMINTERN_NONE;
+}
+
+const char * memintern_str(memintern_s * in, const char * str){
+	size_t id = memintern_add(in, str, strlen(str));
+	if(id == MEMINTERN_NONE){
+		return NULL;
+	}
+	
+	return in->strings[id].str;
+}
+
+const memstring_s * memintern_at(memintern_s * in, size_t id){
+	return in->strings + id;
+}
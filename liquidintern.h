@@ -0,0 +1,149 @@
+/**
+ * LiquidMem: string interning in rivers.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidintern.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDINTERN_H
+#define LIQUIDINTERN_H
+
+#include <stdint.h> /* uint32_t, uint64_t */
+
+#include "liquidmem.h"
+
+/** Returned for strings that are not interned. */
+#define MEMINTERN_NONE ((size_t)-1)
+
+/**
+ * An interned string. Its characters live in the river of the interning table
+ * and are nul-terminated.
+ */
+typedef struct memstring{
+	/** The characters. */
+	const char * str;
+	/** The number of characters, excluding the nul. */
+	size_t length;
+	/** The hash of the characters. */
+	uint64_t hash;
+} memstring_s;
+
+/**
+ * An interning table keeps one copy of every distinct string added to it, in a
+ * river. Each string gets an ID, counting up from 0, and a pointer that stays
+ * the same until the table is reset, so interned strings can be compared by ID
+ * or pointer.
+ */
+typedef struct memintern{
+	/** The number of strings. */
+	size_t length;
+	/** The number of strings there is room for in strings. */
+	size_t capacity;
+	/** The number of buckets, a power of 2. */
+	size_t size;
+	
+	/** The strings, by ID. */
+	memstring_s * strings;
+	/** The buckets: 1 + the ID of their string, or 0 if empty. */
+	uint32_t * buckets;
+	/** The river for the characters. */
+	memriver_s river;
+} memintern_s;
+
+/**
+ * Initialize an interning table.
+ *
+ * @param in The table to initialize.
+ * @param creekSize The size of the creeks of the table's river.
+ * @return in if successful, NULL on error.
+ */
+memintern_s * memintern_init(memintern_s * in, size_t creekSize);
+/**
+ * Malloc and initialize an interning table.
+ *
+ * @param creekSize The size of the creeks of the table's river.
+ * @return An initialized table, or NULL on error.
+ */
+memintern_s * memintern_make(size_t creekSize);
+/**
+ * Reset an interning table: forget all strings, but keep the storage.
+ *
+ * @param in The table to reset.
+ * @return in, or NULL on error.
+ */
+memintern_s * memintern_reset(memintern_s * in);
+/**
+ * De-initialize an interning table: forget all strings and invalidate the
+ * storage.
+ *
+ * @param in The table to clear.
+ * @return in.
+ */
+memintern_s * memintern_clear(memintern_s * in);
+/**
+ * Clear and free an interning table that was made with memintern_make.
+ *
+ * @param in The table to free, must have been obtained with memintern_make.
+ */
+void memintern_free(memintern_s * in);
+/**
+ * Intern a string: copy it into the table, unless it already is.
+ *
+ * @param in The table.
+ * @param str The characters of the string, need not be nul-terminated.
+ * @param length The number of characters.
+ * @return The ID of the string, or MEMINTERN_NONE on error.
+ */
+size_t memintern_add(memintern_s * in, const char * str, size_t length);
+/**
+ * Look up the ID of a string, without interning it.
+ *
+ * @param in The table.
+ * @param str The characters of the string, need not be nul-terminated.
+ * @param length The number of characters.
+ * @return The ID of the string, or MEMINTERN_NONE if it is not interned.
+ */
+size_t memintern_find(memintern_s * in, const char * str, size_t length);
+/**
+ * Intern a nul-terminated string, see memintern_add.
+ *
+ * @param in The table.
+ * @param str The string.
+ * @return The interned copy of the string, or NULL on error.
+ */
+const char * memintern_str(memintern_s * in, const char * str);
+/**
+ * Get an interned string by its ID.
+ *
+ * @param in The table.
+ * @param id The ID, obtained from memintern_add on in.
+ * @return The string.
+ */
+const memstring_s * memintern_at(memintern_s * in, size_t id);
+
+#endif /* LIQUIDINTERN_H */
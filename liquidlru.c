@@ -0,0 +1,174 @@
+/**
+ * LiquidMem: least recently used caches in pools.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidlru.c
+ *
+ * See README.md for quick-start info and liquidlru.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+
+#include "liquidmem.h"
+#include "liquidmap.h"
+#include "liquidlru.h"
+
+static void unlinkNode(memlrunode_s * node){
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+}
+
+static void pushFront(memlru_s * lru, memlrunode_s * node){
+	node->prev = &lru->list;
+	node->next = lru->list.next;
+	node->next->prev = node;
+	lru->list.next = node;
+}
+
+/* The alignment of a node. */
+#define NODE_ALIGN offsetof(struct{char c; memlrunode_s node;}, node)
+
+/* The key of an entry comes first in the map's entry, then its node after any
+ * padding. */
+static const void * nodeKey(memlru_s * lru, memlrunode_s * node){
+	return (char *)node - lru->nodeOffset;
+}
+
+/* The node of an entry, from its value in the map. */
+static memlrunode_s * entryNode(memlru_s * lru, void * value){
+	if(!value){
+		return NULL;
+	}
+	
+	return (memlrunode_s *)((char *)value - lru->map.keySize + 
+			lru->nodeOffset);
+}
+
+memlru_s * memlru_init(memlru_s * lru, size_t capacity, size_t keySize,
+		size_t valueSize){
+	lru->capacity = capacity;
+	lru->list.prev = lru->list.next = &lru->list;
+	
+	// keep the nodes aligned, in every entry of the pool
+	lru->nodeOffset = (keySize + NODE_ALIGN - 1) / NODE_ALIGN * NODE_ALIGN;
+	size_t entry = lru->nodeOffset + sizeof(memlrunode_s) + valueSize;
+	entry = (entry + NODE_ALIGN - 1) / NODE_ALIGN * NODE_ALIGN;
+	
+	if(!memmap_init(&lru->map, capacity, keySize, entry - keySize)){
+		return NULL;
+	}
+	
+	return lru;
+}
+
+memlru_s * memlru_make(size_t capacity, size_t keySize, size_t valueSize){
+	memlru_s * ret = malloc(sizeof *ret);
+	if(!ret){
+		return NULL;
+	}
+	
+	return memlru_init(ret, capacity, keySize, valueSize);
+}
+
+memlru_s * memlru_reset(memlru_s * lru){
+	memmap_reset(&lru->map);
+	lru->list.prev = lru->list.next = &lru->list;
+	
+	return lru;
+}
+
+memlru_s * memlru_clear(memlru_s * lru){
+	memmap_clear(&lru->map);
+	lru->list.prev = lru->list.next = &lru->list;
+	
+	return lru;
+}
+
+void memlru_free(memlru_s * lru){
+	memlru_clear(lru);
+	free(lru);
+}
+
+void * memlru_peek(memlru_s * lru, const void * key){
+	memlrunode_s * node = entryNode(lru, memmap_get(&lru->map, key));
+	
+	return node ? node + 1 : NULL;
+}
+
+void * memlru_get(memlru_s * lru, const void * key){
+	memlrunode_s * node = entryNode(lru, memmap_get(&lru->map, key));
+	if(!node){
+		return NULL;
+	}
+	
+	unlinkNode(node);
+	pushFront(lru, node);
+	
+	return node + 1;
+}
+
+void * memlru_put(memlru_s * lru, const void * key){
+	void * ret = memlru_get(lru, key);
+	if(ret){
+		return ret;
+	}
+	
+	// evict the oldest, its slot in the pool is the one the new entry gets
+	if(lru->map.length >= lru->capacity){
+		memlrunode_s * oldest = lru->list.prev;
+		unlinkNode(oldest);
+		memmap_remove(&lru->map, nodeKey(lru, oldest));
+	}
+	
+	memlrunode_s * node = entryNode(lru, memmap_put(&lru->map, key));
+	if(!node){
+		return NULL;
+	}
+	pushFront(lru, node);
+	
+	return node + 1;
+}
+
+const void * memlru_oldest(memlru_s * lru){
+	if(lru->list.prev == &lru->list){
+		return NULL;
+	}
+	
+	return nodeKey(lru, lru->list.prev);
+}
+
+memlru_s * memlru_remove(memlru_s * lru, const void * key){
+	memlrunode_s * node = entryNode(lru, memmap_get(&lru->map, key));
+	if(!node){
+		return NULL;
+	}
+	
+	unlinkNode(node);
+	memmap_remove(&lru->map, key);
+	
+	return lru;
+}
@@ -0,0 +1,152 @@
+/**
+ * LiquidMem: least recently used caches in pools.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidlru.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDLRU_H
+#define LIQUIDLRU_H
+
+#include "liquidmem.h"
+#include "liquidmap.h"
+
+/**
+ * The recency links of an entry in a cache. The value follows directly after.
+ */
+typedef struct memlrunode{
+	/** The next more recently used entry. */
+	struct memlrunode * prev;
+	/** The next less recently used entry. */
+	struct memlrunode * next;
+} memlrunode_s;
+
+/**
+ * A cache holds up to a fixed number of entries, and evicts the least recently
+ * used entry to make room for a new one. The entries, with their links, are 
+ * the values of a map and so live in its pool: eviction releases the slot of
+ * the old entry and the new one is allocated in its place.
+ */
+typedef struct memlru{
+	/** The maximum number of entries. */
+	size_t capacity;
+	/** The offset of the node in an entry: the key size, rounded up to the
+	 *  node's alignment. */
+	size_t nodeOffset;
+	/** The links of the list: next is the most, prev the least recent entry. */
+	memlrunode_s list;
+	/** The entries. */
+	memmap_s map;
+} memlru_s;
+
+/**
+ * Initialize a cache. The pool of its map holds all entries in one bath. Keys
+ * are hashed and compared byte for byte, so they shouldn't contain padding. 
+ * Values are aligned like pointers.
+ *
+ * @param lru The cache to initialize.
+ * @param capacity The maximum number of entries.
+ * @param keySize The size of the keys.
+ * @param valueSize The size of the values.
+ * @return lru if successful, NULL on error.
+ */
+memlru_s * memlru_init(memlru_s * lru, size_t capacity, size_t keySize,
+		size_t valueSize);
+/**
+ * Malloc and initialize a cache.
+ *
+ * @param capacity The maximum number of entries.
+ * @param keySize The size of the keys.
+ * @param valueSize The size of the values.
+ * @return An initialized cache, or NULL on error.
+ */
+memlru_s * memlru_make(size_t capacity, size_t keySize, size_t valueSize);
+/**
+ * Reset a cache: remove all entries.
+ *
+ * @param lru The cache to reset.
+ * @return lru.
+ */
+memlru_s * memlru_reset(memlru_s * lru);
+/**
+ * De-initialize a cache: remove all entries and invalidate the storage.
+ *
+ * @param lru The cache to clear.
+ * @return lru.
+ */
+memlru_s * memlru_clear(memlru_s * lru);
+/**
+ * Clear and free a cache that was made with memlru_make.
+ *
+ * @param lru The cache to free, must have been obtained with memlru_make.
+ */
+void memlru_free(memlru_s * lru);
+/**
+ * Look up the value of a key and mark it as the most recently used.
+ *
+ * @param lru The cache.
+ * @param key The key.
+ * @return The value, or NULL if the key is not in the cache.
+ */
+void * memlru_get(memlru_s * lru, const void * key);
+/**
+ * Look up the value of a key, without changing its recency.
+ *
+ * @param lru The cache.
+ * @param key The key.
+ * @return The value, or NULL if the key is not in the cache.
+ */
+void * memlru_peek(memlru_s * lru, const void * key);
+/**
+ * Insert a key, if it isn't in the cache yet, and mark it as the most recently
+ * used. If the cache is full the least recently used entry is evicted; use
+ * memlru_oldest first to see which one that is.
+ *
+ * @param lru The cache.
+ * @param key The key.
+ * @return The value of the key, uninitialized if the key is new, or NULL on
+ *         error.
+ */
+void * memlru_put(memlru_s * lru, const void * key);
+/**
+ * Get the key of the least recently used entry, the next to be evicted.
+ *
+ * @param lru The cache.
+ * @return The key, or NULL if the cache is empty.
+ */
+const void * memlru_oldest(memlru_s * lru);
+/**
+ * Remove a key from the cache.
+ *
+ * @param lru The cache.
+ * @param key The key.
+ * @return lru, or NULL if the key was not in the cache.
+ */
+memlru_s * memlru_remove(memlru_s * lru, const void * key);
+
+#endif /* LIQUIDLRU_H */
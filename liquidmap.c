@@ -0,0 +1,348 @@
+/**
+ * LiquidMem: hash maps with entries in pools.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidmap.c
+ *
+ * See README.md for quick-start info and liquidmap.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "liquidmem.h"
+#include "liquidmap.h"
+
+/** Tag of a bucket that never held an entry. */
+#define EMPTY 0x80
+/** Tag of a bucket whose entry was removed. */
+#define REMOVED 0xFE
+/** Returned for buckets that weren't found. */
+#define NO_BUCKET ((size_t)-1)
+
+/*
+ * Hashing & probing
+ */
+
+uint64_t memmap_hash(const void * key, size_t size){
+	const unsigned char * bytes = key;
+	uint64_t hash = 14695981039346656037ULL;
+	
+	for(size_t i = 0; i < size; i++){
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	
+	return hash;
+}
+
+/* Bit-mask of the tags in the group that are equal to tag. */
+static unsigned int matchTag(const unsigned char * group, unsigned char tag){
+#ifdef __SSE2__
+	__m128i tags = _mm_loadu_si128((const __m128i *)group);
+	__m128i eq = _mm_cmpeq_epi8(tags, _mm_set1_epi8((char)tag));
+	
+	return (unsigned int)_mm_movemask_epi8(eq);
+#else /* !__SSE2__ */
+	unsigned int mask = 0;
+	for(unsigned int i = 0; i < MEMMAP_GROUP; i++){
+		mask |= (unsigned int)(group[i] == tag) << i;
+	}
+	
+	return mask;
+#endif /* __SSE2__ */
+}
+
+/* Bit-mask of the buckets in the group that are empty or removed. */
+static unsigned int matchFree(const unsigned char * group){
+#ifdef __SSE2__
+	// both have the high bit set, tags of entries don't
+	__m128i tags = _mm_loadu_si128((const __m128i *)group);
+	
+	return (unsigned int)_mm_movemask_epi8(tags);
+#else /* !__SSE2__ */
+	unsigned int mask = 0;
+	for(unsigned int i = 0; i < MEMMAP_GROUP; i++){
+		mask |= (unsigned int)(group[i] >> 7) << i;
+	}
+	
+	return mask;
+#endif /* __SSE2__ */
+}
+
+/* Index of the lowest set bit in a non-zero mask. */
+static unsigned int lowestBit(unsigned int mask){
+#ifdef __GNUC__
+	return __builtin_ctz(mask);
+#else /* !__GNUC__ */
+	unsigned int i = 0;
+	while(!(mask & 1)){
+		mask >>= 1;
+		i++;
+	}
+	
+	return i;
+#endif /* __GNUC__ */
+}
+
+static char * entry(memmap_s * map, size_t bucket){
+	return mempool_at(&map->pool, map->refs[bucket] - 1);
+}
+
+/* 
+ * Groups are probed in triangular steps, which visits every group when there
+ * is a power of 2 of them. A group with an empty bucket ends the probe.
+ */
+
+static size_t findBucket(memmap_s * map, const void * key, uint64_t hash){
+	size_t mask = map->size / MEMMAP_GROUP - 1;
+	size_t group = (size_t)(hash >> 7) & mask;
+	unsigned char tag = hash & 0x7F;
+	
+	for(size_t step = 1; step <= mask + 1; step++){
+		unsigned char * tags = map->tags + group * MEMMAP_GROUP;
+		
+		for(unsigned int m = matchTag(tags, tag); m; m &= m - 1){
+			size_t bucket = group * MEMMAP_GROUP + lowestBit(m);
+			if(!memcmp(entry(map, bucket), key, map->keySize)){
+				return bucket;
+			}
+		}
+		
+		if(matchTag(tags, EMPTY)){
+			break;
+		}
+		group = (group + step) & mask;
+	}
+	
+	return NO_BUCKET;
+}
+
+static size_t freeBucket(memmap_s * map, uint64_t hash){
+	size_t mask = map->size / MEMMAP_GROUP - 1;
+	size_t group = (size_t)(hash >> 7) & mask;
+	
+	for(size_t step = 1; step <= mask + 1; step++){
+		unsigned int m = matchFree(map->tags + group * MEMMAP_GROUP);
+		if(m){
+			return group * MEMMAP_GROUP + lowestBit(m);
+		}
+		group = (group + step) & mask;
+	}
+	
+	return NO_BUCKET;
+}
+
+/* Re-insert all entries into fresh buckets, growing them if needed. */
+static memmap_s * rehash(memmap_s * map){
+	size_t size = map->size;
+	while((map->length + 1) * 16 > size * 7){
+		size *= 2;
+	}
+	
+	unsigned char * tags = malloc(size);
+	uint32_t * refs = malloc(size * sizeof *refs);
+	if(!tags || !refs){
+		free(tags);
+		free(refs);
+		return NULL;
+	}
+	memset(tags, EMPTY, size);
+	
+	unsigned char * oldTags = map->tags;
+	uint32_t * oldRefs = map->refs;
+	size_t oldSize = map->size;
+	
+	map->tags = tags;
+	map->refs = refs;
+	map->size = size;
+	map->used = map->length;
+	
+	for(size_t i = 0; i < oldSize; i++){
+		if(oldTags[i] & 0x80){
+			continue;
+		}
+		
+		char * ent = mempool_at(&map->pool, oldRefs[i] - 1);
+		uint64_t hash = memmap_hash(ent, map->keySize);
+		size_t bucket = freeBucket(map, hash);
+		
+		map->tags[bucket] = hash & 0x7F;
+		map->refs[bucket] = oldRefs[i];
+	}
+	
+	free(oldTags);
+	free(oldRefs);
+	
+	return map;
+}
+
+/*
+ * Map functions
+ */
+
+/* The size of an entry, padded so the next entry's key is as aligned as the
+ * key size allows (up to 16). */
+static size_t entrySize(size_t keySize, size_t valueSize){
+	size_t align = keySize & -keySize;
+	if(!align || align > 16){
+		align = 16;
+	}
+	
+	return (keySize + valueSize + align - 1) & ~(align - 1);
+}
+
+memmap_s * memmap_init(memmap_s * map, size_t bathSize, size_t keySize,
+		size_t valueSize){
+	map->length = 0;
+	map->size = MEMMAP_GROUP;
+	map->used = 0;
+	map->keySize = keySize;
+	
+	map->tags = malloc(map->size);
+	map->refs = malloc(map->size * sizeof *map->refs);
+	if(!map->tags || !map->refs){
+		return NULL;
+	}
+	memset(map->tags, EMPTY, map->size);
+	
+	if(!mempool_init(&map->pool, bathSize, entrySize(keySize, valueSize))){
+		return NULL;
+	}
+	
+	return map;
+}
+
+memmap_s * memmap_make(size_t bathSize, size_t keySize, size_t valueSize){
+	memmap_s * ret = malloc(sizeof *ret);
+	if(!ret){
+		return NULL;
+	}
+	
+	return memmap_init(ret, bathSize, keySize, valueSize);
+}
+
+memmap_s * memmap_reset(memmap_s * map){
+	mempool_recycle(&map->pool);
+	memset(map->tags, EMPTY, map->size);
+	map->length = 0;
+	map->used = 0;
+	
+	return map;
+}
+
+memmap_s * memmap_clear(memmap_s * map){
+	mempool_clear(&map->pool);
+	free(map->tags);
+	free(map->refs);
+	
+	map->tags = NULL;
+	map->refs = NULL;
+	map->length = 0;
+	map->size = 0;
+	map->used = 0;
+	
+	return map;
+}
+
+void memmap_free(memmap_s * map){
+	memmap_clear(map);
+	free(map);
+}
+
+void * memmap_get(memmap_s * map, const void * key){
+	size_t bucket = findBucket(map, key, memmap_hash(key, map->keySize));
+	if(bucket == NO_BUCKET){
+		return NULL;
+	}
+	
+	return entry(map, bucket) + map->keySize;
+}
+
+void * memmap_put(memmap_s * map, const void * key){
+	uint64_t hash = memmap_hash(key, map->keySize);
+	size_t bucket = findBucket(map, key, hash);
+	if(bucket != NO_BUCKET){
+		return entry(map, bucket) + map->keySize;
+	}
+	
+	// keep at most 7/8 of the buckets in use, so probes end quickly
+	if((map->used + 1) * 8 > map->size * 7 && !rehash(map)){
+		return NULL;
+	}
+	
+	size_t index;
+	char * ent = mempool_alloc_index(&map->pool, &index);
+	if(!ent){
+		return NULL;
+	}
+	if(index >= UINT32_MAX){
+		mempool_release_index(&map->pool, index);
+		return NULL;
+	}
+	memcpy(ent, key, map->keySize);
+	
+	bucket = freeBucket(map, hash);
+	if(map->tags[bucket] == EMPTY){
+		map->used++;
+	}
+	map->tags[bucket] = hash & 0x7F;
+	map->refs[bucket] = (uint32_t)(index + 1);
+	map->length++;
+	
+	return ent + map->keySize;
+}
+
+memmap_s * memmap_remove(memmap_s * map, const void * key){
+	size_t bucket = findBucket(map, key, memmap_hash(key, map->keySize));
+	if(bucket == NO_BUCKET){
+		return NULL;
+	}
+	
+	mempool_release_index(&map->pool, map->refs[bucket] - 1);
+	map->length--;
+	
+	// a probe won't go past a group with an empty bucket, so if this group
+	// has one the bucket can be emptied instead of marked as removed
+	unsigned char * tags = map->tags + bucket / MEMMAP_GROUP * MEMMAP_GROUP;
+	if(matchTag(tags, EMPTY)){
+		map->tags[bucket] = EMPTY;
+		map->used--;
+	}else{
+		map->tags[bucket] = REMOVED;
+	}
+	
+	return map;
+}
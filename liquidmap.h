@@ -0,0 +1,145 @@
+/**
+ * LiquidMem: hash maps with entries in pools.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidmap.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDMAP_H
+#define LIQUIDMAP_H
+
+#include <stdint.h> /* uint32_t */
+
+#include "liquidmem.h"
+
+/** The number of buckets probed at once. */
+#define MEMMAP_GROUP 16
+
+/**
+ * A map associates fixed-size keys with fixed-size values. The entries (a key
+ * followed by its value) live in a pool. The buckets only hold a 7-bit tag of
+ * each key's hash and a 32-bit reference to the entry's index in the pool, and
+ * are probed a group of tags at a time.
+ */
+typedef struct memmap{
+	/** The number of entries. */
+	size_t length;
+	/** The number of buckets, a power of 2 and at least MEMMAP_GROUP. */
+	size_t size;
+	/** The number of buckets that are not empty, including removed ones. */
+	size_t used;
+	/** The size of the keys. */
+	size_t keySize;
+	
+	/** The tags of the buckets. */
+	unsigned char * tags;
+	/** The entries of the buckets: 1 + their index in the pool. */
+	uint32_t * refs;
+	/** The entries. */
+	mempool_s pool;
+} memmap_s;
+
+/**
+ * Hash a key: FNV-1a, with a final mix so the low and high bits are both 
+ * usable.
+ *
+ * @param key The key.
+ * @param size The size of the key.
+ * @return The hash.
+ */
+uint64_t memmap_hash(const void * key, size_t size);
+/**
+ * Initialize a map. Keys are hashed and compared byte for byte, so they 
+ * shouldn't contain padding. Values follow their key in the entry, so keySize
+ * should be a multiple of the values' alignment.
+ *
+ * @param map The map to initialize.
+ * @param bathSize The number of entries per bath of the pool.
+ * @param keySize The size of the keys.
+ * @param valueSize The size of the values.
+ * @return map if successful, NULL on error.
+ */
+memmap_s * memmap_init(memmap_s * map, size_t bathSize, size_t keySize,
+		size_t valueSize);
+/**
+ * Malloc and initialize a map.
+ *
+ * @param bathSize The number of entries per bath of the pool.
+ * @param keySize The size of the keys.
+ * @param valueSize The size of the values.
+ * @return An initialized map, or NULL on error.
+ */
+memmap_s * memmap_make(size_t bathSize, size_t keySize, size_t valueSize);
+/**
+ * Reset a map: remove all entries, but keep the buckets and the pool's baths.
+ *
+ * @param map The map to reset.
+ * @return map.
+ */
+memmap_s * memmap_reset(memmap_s * map);
+/**
+ * De-initialize a map: remove all entries and invalidate the storage.
+ *
+ * @param map The map to clear.
+ * @return map.
+ */
+memmap_s * memmap_clear(memmap_s * map);
+/**
+ * Clear and free a map that was made with memmap_make.
+ *
+ * @param map The map to free, must have been obtained with memmap_make.
+ */
+void memmap_free(memmap_s * map);
+/**
+ * Look up the value of a key.
+ *
+ * @param map The map.
+ * @param key The key.
+ * @return The value, or NULL if the key is not in the map.
+ */
+void * memmap_get(memmap_s * map, const void * key);
+/**
+ * Insert a key, if it isn't in the map yet. The value stays put until the key
+ * is removed.
+ *
+ * @param map The map.
+ * @param key The key.
+ * @return The value of the key, uninitialized if the key is new, or NULL on
+ *         error.
+ */
+void * memmap_put(memmap_s * map, const void * key);
+/**
+ * Remove a key and release its entry back to the pool.
+ *
+ * @param map The map.
+ * @param key The key.
+ * @return map, or NULL if the key was not in the map.
+ */
+memmap_s * memmap_remove(memmap_s * map, const void * key);
+
+#endif /* LIQUIDMAP_H */
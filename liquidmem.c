@@ -30,12 +30,27 @@
  * the software.
  */
 
+/* Map large river items directly from the system where that is possible. */
+#if !defined(NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define USE_MMAP
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS */
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <limits.h>
 #include <stddef.h>
 #include <string.h>
+#include <stdarg.h>
+
+#ifdef USE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif /* USE_MMAP */
 
 #include "bitarray.h"
 
@@ -50,6 +65,9 @@ membath_s * membath_init(membath_s * bath, size_t size, size_t itemSize){
 	bath->itemSize = itemSize;
 	bath->length = 0;
 	bath->firstFree = 0;
+	bath->generations = NULL;
+	bath->pinMap = NULL;
+	bath->markMap = NULL;
 	
 	size_t bitSize = bitArray_size(bath->size);
 	bath->useMap = calloc(bitSize, sizeof *bath->useMap);
@@ -78,7 +96,22 @@ membath_s * membath_reset(membath_s * bath){
 	bath->length = 0;
 	bath->firstFree = 0;
 	
+	// the items are released, so handles to them must go stale
+	if(bath->generations){
+		for(size_t i = 0; i < bath->size; i++){
+			if(bitArray_test(bath->useMap, i)){
+				bath->generations[i]++;
+			}
+		}
+	}
+	
 	bitArray_zeroe(bath->useMap, bath->size);
+	if(bath->pinMap){
+		bitArray_zeroe(bath->pinMap, bath->size);
+	}
+	if(bath->markMap){
+		bitArray_zeroe(bath->markMap, bath->size);
+	}
 	
 	return bath;
 }
@@ -86,8 +119,14 @@ membath_s * membath_reset(membath_s * bath){
 membath_s * membath_clear(membath_s * bath){
 	free(bath->data);
 	free(bath->useMap);
+	free(bath->generations);
+	free(bath->pinMap);
+	free(bath->markMap);
 	
 	bath->data = NULL;
+	bath->generations = NULL;
+	bath->pinMap = NULL;
+	bath->markMap = NULL;
 	return bath;
 }
 
@@ -103,7 +142,8 @@ void * membath_alloc(membath_s * bath){
 	
 	size_t item = bath->firstFree;
 	bitArray_set(bath->useMap, item);
-	for(size_t i = item; i < bath->size; i++){
+	bath->firstFree = bath->size;
+	for(size_t i = item + 1; i < bath->size; i++){
 		if(!bitArray_test(bath->useMap, i)){
 			bath->firstFree = i;
 			break;
@@ -115,6 +155,31 @@ void * membath_alloc(membath_s * bath){
 	return bath->data + item * bath->itemSize;
 }
 
+/* Release a slot of the bath, if it is in use. */
+static membath_s * releaseSlot(membath_s * bath, size_t item){
+	if(item >= bath->size || !bitArray_test(bath->useMap, item)){
+		return NULL;
+	}
+	
+	if(item < bath->firstFree){
+		bath->firstFree = item;
+	}
+	if(bath->generations){
+		bath->generations[item]++;
+	}
+	if(bath->pinMap){
+		bitArray_clear(bath->pinMap, item);
+	}
+	if(bath->markMap){
+		bitArray_clear(bath->markMap, item);
+	}
+	
+	bitArray_clear(bath->useMap, item);
+	bath->length--;
+	
+	return bath;
+}
+
 membath_s * membath_release(membath_s * bath, void * vptr){
 	char * ptr = vptr;
 	char * end = bath->data + bath->size * bath->itemSize;
@@ -140,14 +205,8 @@ membath_s * membath_release(membath_s * bath, void * vptr){
 	}
 	
 	size_t item = itemOffset / bath->itemSize;
-	if(item < bath->firstFree){
-		bath->firstFree = item;
-	}
-	
-	bitArray_clear(bath->useMap, item);
-	bath->length--;
 	
-	return bath;
+	return releaseSlot(bath, item);
 }
 
 /*
@@ -156,8 +215,11 @@ membath_s * membath_release(membath_s * bath, void * vptr){
 
 mempool_s * mempool_init(mempool_s * pool, size_t bathSize, size_t itemSize){
 	pool->length = 1;
+	pool->capacity = 1;
+	pool->firstFree = 0;
 	pool->bathSize = bathSize;
 	pool->itemSize = itemSize;
+	pool->generation = 0;
 	
 	pool->baths = malloc(pool->length * sizeof *pool->baths);
 	if(!pool->baths){
@@ -181,11 +243,13 @@ mempool_s * mempool_make(size_t bathSize, size_t itemSize){
 }
 
 mempool_s * mempool_reset(mempool_s * pool){
-	while(pool->length --> 1){
-		membath_clear(pool->baths + pool->length);
+	while(pool->capacity --> 1){
+		membath_clear(pool->baths + pool->capacity);
 	}
 	
 	pool->length = 1;
+	pool->capacity = 1;
+	pool->firstFree = 0;
 	
 	membath_s * bths = realloc(pool->baths, pool->length * sizeof *pool->baths);
 	if(!bths){       // The realloc shouldn't ever alloc more than previous
@@ -198,13 +262,28 @@ mempool_s * mempool_reset(mempool_s * pool){
 	return pool;
 }
 
+mempool_s * mempool_recycle(mempool_s * pool){
+	// baths past length are still empty from the last time
+	while(pool->length --> 1){
+		membath_reset(pool->baths + pool->length);
+	}
+	
+	pool->length = 1;
+	pool->firstFree = 0;
+	membath_reset(pool->baths);
+	
+	return pool;
+}
+
 mempool_s * mempool_clear(mempool_s * pool){
-	while(pool->length--){
-		membath_clear(pool->baths + pool->length);
+	while(pool->capacity--){
+		membath_clear(pool->baths + pool->capacity);
 	}
 	
 	free(pool->baths);
 	pool->length = 0;
+	pool->capacity = 0;
+	pool->firstFree = 0;
 	pool->baths = NULL;
 	
 	return pool;
@@ -215,14 +294,34 @@ void mempool_free(mempool_s * pool){
 	free(pool);
 }
 
-void * mempool_alloc(mempool_s * pool){
-	void * ret = membath_alloc(pool->baths + pool->length - 1);
+/* Give a bath whose slots were freed by mempool_compact new ones. */
+static membath_s * refillBath(membath_s * bath){
+	if(!bath->data){
+		bath->data = malloc(bath->size * bath->itemSize);
+		if(!bath->data){
+			return NULL;
+		}
+	}
 	
-	if(ret){
-		return ret;
+	return bath;
+}
+
+/* Find a bath with a free slot, adding one if needed. */
+static membath_s * freeBath(mempool_s * pool){
+	// fill up the holes left by releases before adding baths
+	for(; pool->firstFree < pool->length; pool->firstFree++){
+		membath_s * bath = pool->baths + pool->firstFree;
+		if(bath->length < bath->size){
+			return refillBath(bath);
+		}
+	}
+	
+	// re-use a bath that was kept by mempool_recycle
+	if(pool->length < pool->capacity){
+		return refillBath(pool->baths + pool->length++);
 	}
 	
-	size_t len = ++pool->length;
+	size_t len = pool->capacity + 1;
 	membath_s * bths = realloc(pool->baths, len * sizeof *pool->baths);
 	
 	if(!bths){
@@ -230,9 +329,35 @@ void * mempool_alloc(mempool_s * pool){
 	}
 	pool->baths = bths;
 	
-	membath_init(pool->baths + len - 1, pool->bathSize, pool->itemSize);
+	if(!membath_init(pool->baths + len - 1, pool->bathSize, pool->itemSize)){
+		return NULL;
+	}
+	pool->length = pool->capacity = len;
+	
+	return pool->baths + len - 1;
+}
+
+void * mempool_alloc(mempool_s * pool){
+	membath_s * bath = freeBath(pool);
+	if(!bath){
+		return NULL;
+	}
+	
+	return membath_alloc(bath);
+}
+
+void * mempool_alloc_index(mempool_s * pool, size_t * index){
+	membath_s * bath = freeBath(pool);
+	if(!bath){
+		return NULL;
+	}
 	
-	ret = membath_alloc(pool->baths + len - 1);
+	// membath_alloc hands out the bath's first free slot
+	size_t item = bath->firstFree;
+	void * ret = membath_alloc(bath);
+	if(ret){
+		*index = (size_t)(bath - pool->baths) * pool->bathSize + item;
+	}
 	
 	return ret;
 }
@@ -244,7 +369,10 @@ mempool_s * mempool_release(mempool_s * pool, void * ptr){
 	
 	for(size_t i = 0; i < pool->length; i++){
 		membath_s * bath = pool->baths + i;
-		if(membath_release(bath, ptr) == bath){
+		if(bath->data && membath_release(bath, ptr) == bath){
+			if(i < pool->firstFree){
+				pool->firstFree = i;
+			}
 			return pool;
 		}
 	}
@@ -252,168 +380,1202 @@ mempool_s * mempool_release(mempool_s * pool, void * ptr){
 	return NULL;
 }
 
-/*
- * Creek functions
- */
+/* Whether ptr points into the bath's storage. */
+static int inBath(membath_s * bath, void * vptr){
+	if(!bath->data){
+		return 0;
+	}
+	
+	char * end = bath->data + bath->size * bath->itemSize;
+	
+#ifdef USE_INTPTR
+	intptr_t iptr = (intptr_t)vptr;
+	return iptr >= (intptr_t)bath->data && iptr < (intptr_t)end;
+#else /* !USE_INTPTR */
+	char * ptr = vptr;
+	return ptr >= bath->data && ptr < end;
+#endif /* USE_INTPTR */
+}
 
-memcreek_s * memcreek_init(memcreek_s * creek, size_t size){
-	creek->size = size;
-	creek->length = 0;
+size_t mempool_index(mempool_s * pool, void * vptr){
+	char * ptr = vptr;
 	
-	creek->data = malloc(size);
-	if(!creek->data){
+	// newer baths first, they're likelier to hold recent items
+	for(size_t i = pool->length; i > 0; i--){
+		membath_s * bath = pool->baths + i - 1;
+		if(inBath(bath, ptr)){
+			size_t item = (size_t)(ptr - bath->data) / pool->itemSize;
+			return (i - 1) * pool->bathSize + item;
+		}
+	}
+	
+	return MEMPOOL_NONE;
+}
+
+mempool_s * mempool_release_index(mempool_s * pool, size_t index){
+	size_t i = index / pool->bathSize;
+	if(i >= pool->length || !releaseSlot(pool->baths + i, index % pool->bathSize)){
 		return NULL;
 	}
 	
-	return creek;
+	if(i < pool->firstFree){
+		pool->firstFree = i;
+	}
+	
+	return pool;
 }
 
-memcreek_s * memcreek_make(size_t size){
-	memcreek_s * ret = malloc(sizeof *ret);
+void * mempool_at(mempool_s * pool, size_t index){
+	membath_s * bath = pool->baths + index / pool->bathSize;
 	
-	if(!ret){
+	return bath->data + (index % pool->bathSize) * pool->itemSize;
+}
+
+/*
+ * Compaction
+ */
+
+/* Set or clear the pin of an item. */
+static mempool_s * setPin(mempool_s * pool, void * ptr, int pin){
+	size_t index = mempool_index(pool, ptr);
+	if(index == MEMPOOL_NONE){
 		return NULL;
 	}
 	
-	return memcreek_init(ret, size);
+	membath_s * bath = pool->baths + index / pool->bathSize;
+	size_t item = index % pool->bathSize;
+	if(!bitArray_test(bath->useMap, item)){
+		return NULL;
+	}
+	
+	// baths only keep pins once one of their items is pinned
+	if(!bath->pinMap){
+		if(!pin){
+			return pool;
+		}
+		bath->pinMap = calloc(bitArray_size(bath->size), sizeof *bath->pinMap);
+		if(!bath->pinMap){
+			return NULL;
+		}
+	}
+	
+	if(pin){
+		bitArray_set(bath->pinMap, item);
+	}else{
+		bitArray_clear(bath->pinMap, item);
+	}
+	
+	return pool;
 }
 
-memcreek_s * memcreek_clear(memcreek_s * creek){
-	free(creek->data);
-	creek->data = NULL;
-	creek->length = 0;
+mempool_s * mempool_pin(mempool_s * pool, void * ptr){
+	return setPin(pool, ptr, 1);
+}
+
+mempool_s * mempool_unpin(mempool_s * pool, void * ptr){
+	return setPin(pool, ptr, 0);
+}
+
+/* Whether any item of a bath is pinned. */
+static int hasPins(membath_s * bath){
+	if(bath->pinMap){
+		for(size_t i = 0; i < bitArray_size(bath->size); i++){
+			if(bath->pinMap[i]){
+				return 1;
+			}
+		}
+	}
 	
-	return creek;
+	return 0;
 }
 
-void memcreek_free(memcreek_s * creek){
-	memcreek_clear(creek);
-	free(creek);
+/* Move the items of src into the free slots of the baths before it, from 
+ * *dst on, along with their marks. */
+static mempool_s * evacuate(mempool_s * pool, membath_s * src, size_t * dst,
+		memrelocate_f relocate, void * ctx){
+	for(size_t i = 0; i < src->size && src->length; i++){
+		if(!bitArray_test(src->useMap, i)){
+			continue;
+		}
+		
+		membath_s * bath = pool->baths + *dst;
+		while(!bath->data || bath->length >= bath->size){
+			bath = pool->baths + ++*dst;
+		}
+		
+		int marked = src->markMap && bitArray_test(src->markMap, i);
+		if(marked && !bath->markMap){
+			bath->markMap = calloc(bitArray_size(bath->size), 
+					sizeof *bath->markMap);
+			if(!bath->markMap){
+				return NULL;
+			}
+		}
+		
+		size_t item = bath->firstFree;
+		char * from = src->data + i * src->itemSize;
+		char * to = membath_alloc(bath);
+		memcpy(to, from, src->itemSize);
+		if(marked){
+			bitArray_set(bath->markMap, item);
+		}
+		if(relocate){
+			relocate(ctx, from, to, src->itemSize);
+		}
+		
+		releaseSlot(src, i);
+	}
+	
+	return pool;
 }
 
-memcreek_s * memcreek_reset(memcreek_s * creek){
-	creek->length = 0;
+/* Free the slots of an empty bath, but keep its place in the pool. Its 
+ * generations go too, so the pool's is raised past them. */
+static void dryBath(mempool_s * pool, membath_s * bath){
+	if(bath->generations){
+		for(size_t i = 0; i < bath->size; i++){
+			if(bath->generations[i] > pool->generation){
+				pool->generation = bath->generations[i];
+			}
+		}
+	}
 	
-	return creek;
+	free(bath->data);
+	free(bath->generations);
+	free(bath->pinMap);
+	free(bath->markMap);
+	
+	bath->data = NULL;
+	bath->generations = NULL;
+	bath->pinMap = NULL;
+	bath->markMap = NULL;
+	bath->firstFree = 0;
 }
 
-void * memcreek_alloc(memcreek_s * creek, size_t sz){
-	if(creek->size - creek->length < sz){
-		return NULL;
+mempool_s * mempool_compact(mempool_s * pool, memrelocate_f relocate,
+		void * ctx){
+	size_t room = 0, dst = 0;
+	for(size_t i = 0; i + 1 < pool->length; i++){
+		if(pool->baths[i].data){
+			room += pool->bathSize - pool->baths[i].length;
+		}
 	}
 	
-	void * ret = creek->data + creek->length;
-	creek->length += sz;
+	// empty the last baths into the holes of the ones before, where they fit,
+	// passing over those with pins
+	for(size_t i = pool->length; i > 1; i--){
+		membath_s * bath = pool->baths + i - 1;
+		if(bath->length && bath->length <= room && !hasPins(bath)){
+			room -= bath->length;
+			if(!evacuate(pool, bath, &dst, relocate, ctx)){
+				return NULL;
+			}
+		}
+		
+		// the bath before is the next to be emptied, not filled
+		if(bath[-1].data){
+			room -= pool->bathSize - bath[-1].length;
+		}
+	}
 	
-	return ret;
+	// free the empty baths, and the ones kept for re-use; those at the end go
+	// altogether, the others keep their place
+	for(size_t i = 1; i < pool->capacity; i++){
+		if(pool->baths[i].data && !pool->baths[i].length){
+			dryBath(pool, pool->baths + i);
+		}
+	}
+	while(pool->capacity > 1 && !pool->baths[pool->capacity - 1].data){
+		membath_clear(pool->baths + --pool->capacity);
+	}
+	if(pool->length > pool->capacity){
+		pool->length = pool->capacity;
+	}
+	pool->firstFree = 0;
+	
+	membath_s * bths = realloc(pool->baths, 
+			pool->capacity * sizeof *pool->baths);
+	if(bths){ // Shrinking; if it fails the old array is fine too.
+		pool->baths = bths;
+	}
+	
+	return pool;
 }
 
 /*
- * River functions
+ * Sweeping
  */
 
-memriver_s * memriver_init(memriver_s * riv, size_t creekSize){
-	riv->creekSize = creekSize;
-	riv->length = 1;
-	
-	riv->creeks = malloc(riv->length * sizeof *riv->creeks);
-	if(!riv->creeks){
-		return NULL;
+/* Number of set bits in a word. */
+static unsigned int bitCount(unsigned int word){
+#ifdef __GNUC__
+	return __builtin_popcount(word);
+#else /* !__GNUC__ */
+	unsigned int count = 0;
+	for(; word; word &= word - 1){
+		count++;
 	}
-	memcreek_init(riv->creeks, creekSize);
 	
-	return riv;
+	return count;
+#endif /* __GNUC__ */
 }
 
-memriver_s * memriver_make(size_t creekSize){
-	memriver_s * ret = malloc(sizeof *ret);
+membath_s * membath_sweep(membath_s * bath){
+	// nothing marked: everything goes
+	if(!bath->markMap){
+		return membath_reset(bath);
+	}
 	
-	if(!ret){
-		return NULL;
+	if(bath->generations){
+		for(size_t i = 0; i < bath->size; i++){
+			if(bitArray_test(bath->useMap, i) && 
+					!bitArray_test(bath->markMap, i)){
+				bath->generations[i]++;
+			}
+		}
 	}
 	
-	return memriver_init(ret, creekSize);
-}
-
-memriver_s * memriver_clear(memriver_s * riv){
-	while(riv->length--){
-		memcreek_clear(riv->creeks + riv->length);
+	bitArray_intersect(bath->size, bath->useMap, bath->markMap);
+	if(bath->pinMap){
+		bitArray_intersect(bath->size, bath->pinMap, bath->markMap);
 	}
 	
-	free(riv->creeks);
-	riv->creeks = NULL;
-	riv->length = 0;
+	bath->length = 0;
+	bath->firstFree = bath->size;
+	for(size_t i = 0; i < bitArray_size(bath->size); i++){
+		unsigned int word = bath->useMap[i];
+		bath->length += bitCount(word);
+		
+		if(bath->firstFree == bath->size && ~word){
+			bath->firstFree = i * BITARRAY_INTBITS +
+					bitCount(word & ~(word + 1));
+		}
+	}
 	
-	return riv;
+	bitArray_zeroe(bath->markMap, bath->size);
+	
+	return bath;
 }
 
-void memriver_free(memriver_s * riv){
-	memriver_clear(riv);
-	free(riv);
+mempool_s * mempool_mark(mempool_s * pool, void * ptr){
+	return mempool_mark_index(pool, mempool_index(pool, ptr));
 }
 
-memriver_s * memriver_reset(memriver_s * riv){
-	while(riv->length --> 1){
-		memcreek_clear(riv->creeks + riv->length);
+mempool_s * mempool_mark_index(mempool_s * pool, size_t index){
+	if(index == MEMPOOL_NONE || index / pool->bathSize >= pool->length){
+		return NULL;
 	}
 	
-	riv->length = 1;
+	membath_s * bath = pool->baths + index / pool->bathSize;
+	size_t item = index % pool->bathSize;
+	if(!bitArray_test(bath->useMap, item)){
+		return NULL;
+	}
 	
-	memcreek_s * crks = realloc(riv->creeks, riv->length * sizeof *riv->creeks);
-	if(!crks){       // The realloc shouldn't ever alloc more than previous
-		return NULL; // size, so this shouldn't really happen. Still...
+	if(!bath->markMap){
+		bath->markMap = calloc(bitArray_size(bath->size), sizeof *bath->markMap);
+		if(!bath->markMap){
+			return NULL;
+		}
 	}
 	
-	riv->creeks = crks;
-	memcreek_reset(riv->creeks);
+	bitArray_set(bath->markMap, item);
 	
-	return riv;
+	return pool;
 }
 
-static memcreek_s * addCreek(memriver_s * riv, size_t size){
-	size_t len = ++riv->length;
-	memcreek_s * crks = realloc(riv->creeks, len * sizeof *riv->creeks);
-	
-	if(!crks){
-		return NULL;
+mempool_s * mempool_sweep(mempool_s * pool){
+	for(size_t i = 0; i < pool->length; i++){
+		membath_sweep(pool->baths + i);
 	}
-	riv->creeks = crks;
-	memcreek_init(riv->creeks + len - 1, size);
 	
-	return riv->creeks + len - 1;
+	pool->firstFree = 0;
+	
+	return pool;
 }
 
-void * memriver_alloc(memriver_s * riv, size_t size){
-	void * ret = NULL;
+/*
+ * Handles: 1 + the item's index in the high bits, the generation of its slot
+ * in the low MEMHANDLE_GENERATION_BITS.
+ */
+
+#define GENERATION_MASK                                                        \
+		(((memhandle_t)1 << MEMHANDLE_GENERATION_BITS) - 1)
+
+/* The index of a handle's item, if the handle is still valid. */
+static size_t handleIndex(mempool_s * pool, memhandle_t handle){
+	if(handle == MEMHANDLE_NONE){
+		return MEMPOOL_NONE;
+	}
 	
-	// size requested exceeds creek size: allocate 1 creek of exactly that size
-	if(size > riv->creekSize){
-		memcreek_s * crk = addCreek(riv, size);
-		if(crk){
-			return memcreek_alloc(crk, size);
-		}else{
-			return NULL;
-		}
+	size_t index = (size_t)(handle >> MEMHANDLE_GENERATION_BITS) - 1;
+	if(index / pool->bathSize >= pool->length){
+		return MEMPOOL_NONE;
 	}
 	
-	// go over the creeks last to first to find a spot (last creek is more 
-	// likely not to be full)
-	for(size_t i = riv->length; i > 0; i--){
-		ret = memcreek_alloc(riv->creeks + i - 1, size);
-		if(ret){
-			break;
-		}
+	size_t item = index % pool->bathSize;
+	membath_s * bath = pool->baths + index / pool->bathSize;
+	
+	if(!bath->generations || !bitArray_test(bath->useMap, item) ||
+			(bath->generations[item] & GENERATION_MASK) != 
+					(handle & GENERATION_MASK)){
+		return MEMPOOL_NONE;
 	}
 	
-	// no existing creek has enough space available, make a new one
+	return index;
+}
+
+void * mempool_alloc_handle(mempool_s * pool, memhandle_t * handle){
+	size_t index;
+	void * ret = mempool_alloc_index(pool, &index);
 	if(!ret){
-		memcreek_s * crk = addCreek(riv, riv->creekSize);
-		if(crk){
-			return memcreek_alloc(crk, size);
-		}else{
+		return NULL;
+	}
+	
+	if(index >= ((memhandle_t)-1 >> MEMHANDLE_GENERATION_BITS)){
+		mempool_release_index(pool, index);
+		return NULL;
+	}
+	
+	// baths only keep generations once handles are handed out for them
+	membath_s * bath = pool->baths + index / pool->bathSize;
+	if(!bath->generations){
+		bath->generations = malloc(bath->size * sizeof *bath->generations);
+		if(!bath->generations){
+			mempool_release_index(pool, index);
 			return NULL;
 		}
+		for(size_t i = 0; i < bath->size; i++){
+			bath->generations[i] = pool->generation;
+		}
 	}
 	
+	*handle = (memhandle_t)(index + 1) << MEMHANDLE_GENERATION_BITS |
+			(bath->generations[index % pool->bathSize] & GENERATION_MASK);
+	
+	return ret;
+}
+
+void * mempool_deref(mempool_s * pool, memhandle_t handle){
+	size_t index = handleIndex(pool, handle);
+	if(index == MEMPOOL_NONE){
+		return NULL;
+	}
+	
+	return mempool_at(pool, index);
+}
+
+mempool_s * mempool_release_handle(mempool_s * pool, memhandle_t handle){
+	size_t index = handleIndex(pool, handle);
+	if(index == MEMPOOL_NONE){
+		return NULL;
+	}
+	
+	return mempool_release_index(pool, index);
+}
+
+/*
+ * Creek functions
+ */
+
+memcreek_s * memcreek_init(memcreek_s * creek, size_t size){
+	creek->size = size;
+	creek->length = 0;
+	creek->count = 0;
+	creek->scratch = 0;
+	
+	creek->data = malloc(size);
+	if(!creek->data){
+		return NULL;
+	}
+	
+	return creek;
+}
+
+memcreek_s * memcreek_make(size_t size){
+	memcreek_s * ret = malloc(sizeof *ret);
+	
+	if(!ret){
+		return NULL;
+	}
+	
+	return memcreek_init(ret, size);
+}
+
+memcreek_s * memcreek_clear(memcreek_s * creek){
+	free(creek->data);
+	creek->data = NULL;
+	creek->length = 0;
+	creek->count = 0;
+	creek->scratch = 0;
+	
+	return creek;
+}
+
+void memcreek_free(memcreek_s * creek){
+	memcreek_clear(creek);
+	free(creek);
+}
+
+memcreek_s * memcreek_reset(memcreek_s * creek){
+	creek->length = 0;
+	creek->count = 0;
+	creek->scratch = 0;
+	
+	return creek;
+}
+
+memcreek_s * memcreek_reset_scratch(memcreek_s * creek){
+	creek->scratch = 0;
+	
+	return creek;
+}
+
+/* The size left between the regular and the scratch items. */
+static size_t creekRoom(memcreek_s * creek){
+	return creek->size - creek->length - creek->scratch;
+}
+
+void * memcreek_alloc(memcreek_s * creek, size_t sz){
+	if(creekRoom(creek) < sz){
+		return NULL;
+	}
+	
+	void * ret = creek->data + creek->length;
+	creek->length += sz;
+	creek->count++;
+	
+	return ret;
+}
+
+void * memcreek_alloc_aligned(memcreek_s * creek, size_t sz, size_t align){
+	uintptr_t end = (uintptr_t)(creek->data + creek->length);
+	size_t pad = (size_t)(-end & (align - 1));
+	
+	if(creekRoom(creek) < pad || creekRoom(creek) - pad < sz){
+		return NULL;
+	}
+	
+	creek->length += pad;
+	
+	return memcreek_alloc(creek, sz);
+}
+
+void * memcreek_alloc_scratch(memcreek_s * creek, size_t sz){
+	if(creekRoom(creek) < sz){
+		return NULL;
+	}
+	
+	creek->scratch += sz;
+	
+	return creek->data + creek->size - creek->scratch;
+}
+
+static int inCreek(memcreek_s * crk, void * vptr){
+	char * end = crk->data + crk->length;
+	
+#ifdef USE_INTPTR
+	intptr_t iptr = (intptr_t)vptr;
+	return iptr >= (intptr_t)crk->data && iptr < (intptr_t)end;
+#else /* !USE_INTPTR */
+	char * ptr = vptr;
+	return ptr >= crk->data && ptr < end;
+#endif /* USE_INTPTR */
+}
+
+/* The header of a lake, padded so its item is aligned like a malloc'd one. */
+#define LAKE_HEADER ((sizeof(memlake_s) + 15) & ~(size_t)15)
+
+static char * lakeItem(memlake_s * lake){
+	return (char *)lake + LAKE_HEADER;
+}
+
+static int inLake(memlake_s * lake, void * vptr){
+	char * start = lakeItem(lake);
+	char * end = (char *)lake + lake->size;
+	
+#ifdef USE_INTPTR
+	intptr_t iptr = (intptr_t)vptr;
+	return iptr >= (intptr_t)start && iptr < (intptr_t)end;
+#else /* !USE_INTPTR */
+	char * ptr = vptr;
+	return ptr >= start && ptr < end;
+#endif /* USE_INTPTR */
+}
+
+/*
+ * Lake functions
+ */
+
+static memlake_s * addLake(memriver_s * riv, size_t size){
+	size_t total = LAKE_HEADER + size;
+	if(total < size){
+		return NULL;
+	}
+	
+#ifdef USE_MMAP
+	memlake_s * lake = mmap(NULL, total, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(lake == MAP_FAILED){
+		return NULL;
+	}
+#else /* !USE_MMAP */
+	memlake_s * lake = malloc(total);
+	if(!lake){
+		return NULL;
+	}
+#endif /* USE_MMAP */
+	
+	lake->size = total;
+	lake->number = riv->lakeCount++;
+	lake->next = riv->lakes;
+	riv->lakes = lake;
+	
+	return lake;
+}
+
+static void dryLake(memlake_s * lake){
+#ifdef USE_MMAP
+	munmap(lake, lake->size);
+#else /* !USE_MMAP */
+	free(lake);
+#endif /* USE_MMAP */
+}
+
+/* Dry up the lakes numbered number and up (all of them if number is 0). */
+static void dryLakes(memriver_s * riv, size_t number){
+	while(riv->lakes && riv->lakes->number >= number){
+		memlake_s * next = riv->lakes->next;
+		dryLake(riv->lakes);
+		riv->lakes = next;
+	}
+	
+	riv->lakeCount = number;
+}
+
+/* Dry up the lakes of scratch items. */
+static void dryScratchLakes(memriver_s * riv){
+	while(riv->scratchLakes){
+		memlake_s * next = riv->scratchLakes->next;
+		dryLake(riv->scratchLakes);
+		riv->scratchLakes = next;
+	}
+}
+
+/*
+ * River functions
+ */
+
+/* Run the deferrals made since the given one. */
+static void runDefers(memriver_s * riv, memdefer_s * until){
+	while(riv->defers && riv->defers != until){
+		memdefer_s * defer = riv->defers;
+		riv->defers = defer->next;
+		defer->fn(defer->arg);
+	}
+}
+
+memriver_s * memriver_init(memriver_s * riv, size_t creekSize){
+	riv->creekSize = creekSize;
+	riv->length = 1;
+	riv->capacity = 1;
+	riv->lakes = NULL;
+	riv->lakeCount = 0;
+	riv->peak = 0;
+	riv->creekMax = 0;
+	riv->defers = NULL;
+	riv->scratchLakes = NULL;
+	
+	riv->creeks = malloc(riv->length * sizeof *riv->creeks);
+	if(!riv->creeks){
+		return NULL;
+	}
+	memcreek_init(riv->creeks, creekSize);
+	
+	return riv;
+}
+
+memriver_s * memriver_make(size_t creekSize){
+	memriver_s * ret = malloc(sizeof *ret);
+	
+	if(!ret){
+		return NULL;
+	}
+	
+	return memriver_init(ret, creekSize);
+}
+
+memriver_s * memriver_clear(memriver_s * riv){
+	runDefers(riv, NULL);
+	dryLakes(riv, 0);
+	dryScratchLakes(riv);
+	
+	while(riv->capacity--){
+		memcreek_clear(riv->creeks + riv->capacity);
+	}
+	
+	free(riv->creeks);
+	riv->creeks = NULL;
+	riv->length = 0;
+	riv->capacity = 0;
+	
+	return riv;
+}
+
+void memriver_free(memriver_s * riv){
+	memriver_clear(riv);
+	free(riv);
+}
+
+memriver_s * memriver_adapt(memriver_s * riv, size_t creekMax){
+	riv->creekMax = creekMax > riv->creekSize ? creekMax : riv->creekSize;
+	
+	return riv;
+}
+
+/* Items larger than this go into lakes. */
+static size_t lakeSize(memriver_s * riv){
+	return riv->creekMax ? riv->creekMax : riv->creekSize;
+}
+
+/* Size of the next creek to add, for an item of the given size. */
+static size_t nextCreekSize(memriver_s * riv, size_t size){
+	if(!riv->creekMax){
+		return riv->creekSize;
+	}
+	
+	// double the last creek, up to the maximum
+	size_t next = riv->creeks[riv->length - 1].size;
+	next = next > riv->creekMax / 2 ? riv->creekMax : next * 2;
+	
+	return next > size ? next : size;
+}
+
+/* Total occupied size of the creeks in use, also tracking the peak. */
+static size_t creekUsage(memriver_s * riv){
+	size_t used = 0;
+	for(size_t i = 0; i < riv->length; i++){
+		used += riv->creeks[i].length + riv->creeks[i].scratch;
+	}
+	
+	if(used > riv->peak){
+		riv->peak = used;
+	}
+	
+	return used;
+}
+
+memriver_s * memriver_reset(memriver_s * riv){
+	runDefers(riv, NULL);
+	creekUsage(riv);
+	dryLakes(riv, 0);
+	dryScratchLakes(riv);
+	
+	while(riv->capacity --> 1){
+		memcreek_clear(riv->creeks + riv->capacity);
+	}
+	
+	riv->length = 1;
+	riv->capacity = 1;
+	
+	memcreek_s * crks = realloc(riv->creeks, riv->length * sizeof *riv->creeks);
+	if(!crks){       // The realloc shouldn't ever alloc more than previous
+		return NULL; // size, so this shouldn't really happen. Still...
+	}
+	
+	riv->creeks = crks;
+	memcreek_reset(riv->creeks);
+	
+	// grow the first creek so it can hold everything up to the peak, if 
+	// adapting
+	size_t size = riv->peak < riv->creekMax ? riv->peak : riv->creekMax;
+	if(riv->creeks->size < size){
+		memcreek_clear(riv->creeks);
+		if(!memcreek_init(riv->creeks, size) &&
+				!memcreek_init(riv->creeks, riv->creekSize)){
+			return NULL;
+		}
+	}
+	
+	return riv;
+}
+
+memriver_s * memriver_recycle(memriver_s * riv, int coalesce){
+	runDefers(riv, NULL);
+	creekUsage(riv);
+	dryLakes(riv, 0);
+	dryScratchLakes(riv);
+	
+	size_t size = riv->peak > riv->creekSize ? riv->peak : riv->creekSize;
+	if(coalesce && (riv->capacity > 1 || riv->creeks->size < size)){
+		while(riv->capacity --> 1){
+			memcreek_clear(riv->creeks + riv->capacity);
+		}
+		riv->capacity = 1;
+		
+		memcreek_s * crks = realloc(riv->creeks, sizeof *riv->creeks);
+		if(crks){ // Shrinking; if it fails the old array is fine too.
+			riv->creeks = crks;
+		}
+		
+		if(riv->creeks->size < size){
+			memcreek_clear(riv->creeks);
+			if(!memcreek_init(riv->creeks, size) &&
+					!memcreek_init(riv->creeks, riv->creekSize)){
+				return NULL;
+			}
+		}
+	}
+	
+	// creeks past length are reset by addCreek when they are re-used
+	riv->length = 1;
+	memcreek_reset(riv->creeks);
+	
+	return riv;
+}
+
+/* Flattening keeps the items' alignment up to this. */
+#define FLATTEN_ALIGN 64
+
+/* Ask for the creek to be backed by huge pages, where supported. */
+static void adviseHuge(memcreek_s * creek){
+#if defined(USE_MMAP) && defined(MADV_HUGEPAGE)
+	uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t start = ((uintptr_t)creek->data + page - 1) & ~(page - 1);
+	uintptr_t end = ((uintptr_t)creek->data + creek->size) & ~(page - 1);
+	
+	// only a hint: if it isn't taken the creek just uses normal pages
+	if(start < end){
+		madvise((void *)start, end - start, MADV_HUGEPAGE);
+	}
+#else /* !(USE_MMAP && MADV_HUGEPAGE) */
+	(void)creek;
+#endif /* USE_MMAP && MADV_HUGEPAGE */
+}
+
+/* Point the links to deferrals, and their arguments, in the creek to where it
+ * was copied. The links are followed from the river, through deferrals that
+ * were copied before. */
+static void relocateDefers(memriver_s * riv, memcreek_s * crk, char * to){
+	for(memdefer_s ** link = &riv->defers; *link; link = &(*link)->next){
+		if(inCreek(crk, *link)){
+			*link = (memdefer_s *)(to + ((char *)*link - crk->data));
+		}
+		if(inCreek(crk, (*link)->arg)){
+			(*link)->arg = to + ((char *)(*link)->arg - crk->data);
+		}
+	}
+}
+
+memriver_s * memriver_flatten(memriver_s * riv, memrelocate_f relocate,
+		void * ctx){
+	size_t size = 0;
+	for(size_t i = 0; i < riv->length; i++){
+		if(riv->creeks[i].length){
+			size += riv->creeks[i].length + FLATTEN_ALIGN - 1;
+		}
+	}
+	
+	memcreek_s flat;
+	if(!memcreek_init(&flat, size ? size : riv->creekSize)){
+		return NULL;
+	}
+	adviseHuge(&flat);
+	
+	for(size_t i = 0; i < riv->length; i++){
+		memcreek_s * crk = riv->creeks + i;
+		if(!crk->length){
+			continue;
+		}
+		
+		// keep the creek's offset from the old data, modulo the alignment
+		char * to = flat.data + flat.length;
+		to += ((uintptr_t)crk->data - (uintptr_t)to) & (FLATTEN_ALIGN - 1);
+		
+		memcpy(to, crk->data, crk->length);
+		relocateDefers(riv, crk, to);
+		if(relocate){
+			relocate(ctx, crk->data, to, crk->length);
+		}
+		flat.length = (size_t)(to - flat.data) + crk->length;
+		flat.count += crk->count;
+	}
+	
+	while(riv->capacity --> 1){
+		memcreek_clear(riv->creeks + riv->capacity);
+	}
+	memcreek_clear(riv->creeks);
+	
+	memcreek_s * crks = realloc(riv->creeks, sizeof *riv->creeks);
+	if(crks){ // Shrinking; if it fails the old array is fine too.
+		riv->creeks = crks;
+	}
+	
+	riv->creeks[0] = flat;
+	riv->length = riv->capacity = 1;
+	
+	return riv;
+}
+
+static memcreek_s * addCreek(memriver_s * riv, size_t size){
+	memcreek_s * crk = riv->creeks + riv->length;
+	
+	// re-use a creek that was kept after a rollback, if it is big enough
+	if(riv->length < riv->capacity){
+		if(crk->size < size){
+			memcreek_clear(crk);
+			if(!memcreek_init(crk, size)){
+				return NULL;
+			}
+		}
+		riv->length++;
+		
+		return memcreek_reset(crk);
+	}
+	
+	size_t len = riv->capacity + 1;
+	memcreek_s * crks = realloc(riv->creeks, len * sizeof *riv->creeks);
+	
+	if(!crks){
+		return NULL;
+	}
+	riv->creeks = crks;
+	
+	crk = riv->creeks + len - 1;
+	if(!memcreek_init(crk, size)){
+		return NULL;
+	}
+	riv->length = riv->capacity = len;
+	
+	return crk;
+}
+
+void * memriver_alloc(memriver_s * riv, size_t size){
+	void * ret = NULL;
+	
+	// size requested exceeds creek size: put it in a lake of its own, so it
+	// doesn't clog up the creeks
+	if(size > lakeSize(riv)){
+		memlake_s * lake = addLake(riv, size);
+		if(lake){
+			return lakeItem(lake);
+		}else{
+			return NULL;
+		}
+	}
+	
+	// go over the creeks last to first to find a spot (last creek is more 
+	// likely not to be full)
+	for(size_t i = riv->length; i > 0; i--){
+		ret = memcreek_alloc(riv->creeks + i - 1, size);
+		if(ret){
+			break;
+		}
+	}
+	
+	// no existing creek has enough space available, make a new one
+	if(!ret){
+		memcreek_s * crk = addCreek(riv, nextCreekSize(riv, size));
+		if(crk){
+			return memcreek_alloc(crk, size);
+		}else{
+			return NULL;
+		}
+	}
+	
+	return ret;
+}
+
+void * memriver_alloc_aligned(memriver_s * riv, size_t size, size_t align){
+	void * ret = NULL;
+	size_t padded = size + align - 1;
+	
+	if(padded < size){
+		return NULL;
+	}
+	
+	// a lake's item is only as aligned as the lake's header allows
+	if(padded > lakeSize(riv)){
+		memlake_s * lake = addLake(riv, padded);
+		if(!lake){
+			return NULL;
+		}
+		
+		uintptr_t start = (uintptr_t)lakeItem(lake);
+		return lakeItem(lake) + (size_t)(-start & (align - 1));
+	}
+	
+	for(size_t i = riv->length; i > 0; i--){
+		ret = memcreek_alloc_aligned(riv->creeks + i - 1, size, align);
+		if(ret){
+			return ret;
+		}
+	}
+	
+	memcreek_s * crk = addCreek(riv, nextCreekSize(riv, padded));
+	if(crk){
+		return memcreek_alloc_aligned(crk, size, align);
+	}else{
+		return NULL;
+	}
+}
+
+void * memriver_alloc_scratch(memriver_s * riv, size_t size){
+	if(size > lakeSize(riv)){
+		// made like a regular lake, then moved to the scratch lakes
+		memlake_s * lake = addLake(riv, size);
+		if(!lake){
+			return NULL;
+		}
+		
+		riv->lakes = lake->next;
+		riv->lakeCount--;
+		lake->next = riv->scratchLakes;
+		riv->scratchLakes = lake;
+		
+		return lakeItem(lake);
+	}
+	
+	for(size_t i = riv->length; i > 0; i--){
+		void * ret = memcreek_alloc_scratch(riv->creeks + i - 1, size);
+		if(ret){
+			return ret;
+		}
+	}
+	
+	memcreek_s * crk = addCreek(riv, nextCreekSize(riv, size));
+	if(crk){
+		return memcreek_alloc_scratch(crk, size);
+	}else{
+		return NULL;
+	}
+}
+
+memriver_s * memriver_reset_scratch(memriver_s * riv){
+	for(size_t i = 0; i < riv->length; i++){
+		memcreek_reset_scratch(riv->creeks + i);
+	}
+	dryScratchLakes(riv);
+	
+	return riv;
+}
+
+/* Find the creek in which ptr is the most recently allocated item. */
+static memcreek_s * topCreek(memriver_s * riv, char * ptr, size_t size){
+	for(size_t i = riv->length; i > 0; i--){
+		memcreek_s * crk = riv->creeks + i - 1;
+		if(crk->length >= size && ptr + size == crk->data + crk->length){
+			return crk;
+		}
+	}
+	
+	return NULL;
+}
+
+/* Unlink a lake from its river and dry it up. */
+static void removeLake(memriver_s * riv, memlake_s * lake){
+	memlake_s ** link = &riv->lakes;
+	while(*link && *link != lake){
+		link = &(*link)->next;
+	}
+	
+	if(*link){
+		*link = lake->next;
+		dryLake(lake);
+	}
+}
+
+void * memriver_realloc(memriver_s * riv, void * vptr, size_t oldSize,
+		size_t size){
+	char * ptr = vptr;
+	memcreek_s * crk = NULL;
+	memlake_s * lake = NULL;
+	
+	if(!ptr){
+		return memriver_alloc(riv, size);
+	}
+	
+	if(oldSize > lakeSize(riv)){
+		// item lives in a lake of its own, which may have room to spare
+		lake = (memlake_s *)(ptr - LAKE_HEADER);
+		if(size <= lake->size - LAKE_HEADER && size > lakeSize(riv)){
+			return ptr;
+		}
+	}else{
+		// shrinking never moves; the last item in its creek can also grow in
+		// place, if it fits, and gives back what it shrinks by
+		crk = topCreek(riv, ptr, oldSize);
+		if(size <= oldSize || (crk && size - oldSize <= creekRoom(crk))){
+			if(crk){
+				crk->length = crk->length - oldSize + size;
+			}
+			return ptr;
+		}
+	}
+	
+	// allocating may move the creeks
+	size_t top = crk ? (size_t)(crk - riv->creeks) : 0;
+	void * ret = memriver_alloc(riv, size);
+	if(!ret){
+		return NULL;
+	}
+	memcpy(ret, ptr, oldSize < size ? oldSize : size);
+	
+	// the old item can be given back if it was on top of its creek, or in a
+	// lake of its own, and otherwise at least doesn't count anymore
+	if(crk){
+		crk = riv->creeks + top;
+		crk->length -= oldSize;
+		crk->count--;
+	}else if(lake){
+		removeLake(riv, lake);
+	}else{
+		memriver_release(riv, ptr);
+	}
+	
+	return ret;
+}
+
+memriver_s * memriver_release(memriver_s * riv, void * ptr){
+	for(size_t i = riv->length; i > 0; i--){
+		memcreek_s * crk = riv->creeks + i - 1;
+		if(!inCreek(crk, ptr)){
+			continue;
+		}
+		
+		// reset it where it is, so the creek indices in marks stay right
+		if(crk->count && !--crk->count && !crk->scratch){
+			memcreek_reset(crk);
+		}
+		
+		return riv;
+	}
+	
+	for(memlake_s * lake = riv->lakes; lake; lake = lake->next){
+		if(inLake(lake, ptr)){
+			removeLake(riv, lake);
+			return riv;
+		}
+	}
+	
+	return NULL;
+}
+
+memriver_s * memriver_defer(memriver_s * riv, memdefer_f fn, void * arg){
+	memdefer_s * defer = memriver_alloc_aligned(riv, sizeof *defer,
+			sizeof(void *));
+	if(!defer){
+		return NULL;
+	}
+	
+	defer->fn = fn;
+	defer->arg = arg;
+	defer->next = riv->defers;
+	riv->defers = defer;
+	
+	return riv;
+}
+
+memmark_s memriver_mark(memriver_s * riv){
+	memmark_s mark;
+	
+	mark.creek = riv->length - 1;
+	mark.length = riv->creeks[mark.creek].length;
+	mark.lakes = riv->lakeCount;
+	mark.defers = riv->defers;
+	
+	return mark;
+}
+
+memriver_s * memriver_rollback(memriver_s * riv, memmark_s mark, int keep){
+	if(mark.creek >= riv->length || mark.lakes > riv->lakeCount){
+		return NULL;
+	}
+	
+	runDefers(riv, mark.defers);
+	dryLakes(riv, mark.lakes);
+	
+	// the creeks after the mark are either kept for addCreek to re-use, or
+	// cleared together with any that were kept before
+	size_t len = mark.creek + 1;
+	if(!keep){
+		while(riv->capacity > len){
+			memcreek_clear(riv->creeks + --riv->capacity);
+		}
+	}
+	riv->length = len;
+	
+	memcreek_s * crk = riv->creeks + mark.creek;
+	if(crk->length > mark.length){
+		crk->length = mark.length;
+	}
+	
+	return riv;
+}
+
+void * memriver_memdup(memriver_s * riv, const void * src, size_t size){
+	void * ret = memriver_alloc(riv, size);
+	if(!ret){
+		return NULL;
+	}
+	
+	return memcpy(ret, src, size);
+}
+
+char * memriver_strdup(memriver_s * riv, const char * str){
+	return memriver_memdup(riv, str, strlen(str) + 1);
+}
+
+char * memriver_strndup(memriver_s * riv, const char * str, size_t n){
+	const char * end = memchr(str, '\0', n);
+	size_t len = end ? (size_t)(end - str) : n;
+	
+	char * ret = memriver_alloc(riv, len + 1);
+	if(!ret){
+		return NULL;
+	}
+	
+	memcpy(ret, str, len);
+	ret[len] = '\0';
+	
+	return ret;
+}
+
+char * memriver_vprintf(memriver_s * riv, const char * fmt, va_list args){
+	memcreek_s * crk = riv->creeks + riv->length - 1;
+	size_t room = creekRoom(crk);
+	char * ret = crk->data + crk->length;
+	va_list copy;
+	
+	// format straight into the rest of the last creek
+	va_copy(copy, args);
+	int len = vsnprintf(ret, room, fmt, copy);
+	va_end(copy);
+	
+	if(len < 0){
+		return NULL;
+	}
+	if((size_t)len < room){
+		crk->length += len + 1;
+		crk->count++;
+		return ret;
+	}
+	
+	// it didn't fit, but now the exact size is known
+	ret = memriver_alloc(riv, (size_t)len + 1);
+	if(ret){
+		vsnprintf(ret, (size_t)len + 1, fmt, args);
+	}
+	
+	return ret;
+}
+
+char * memriver_printf(memriver_s * riv, const char * fmt, ...){
+	va_list args;
+	
+	va_start(args, fmt);
+	char * ret = memriver_vprintf(riv, fmt, args);
+	va_end(args);
+	
 	return ret;
 }
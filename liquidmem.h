@@ -33,6 +33,26 @@
 #ifndef MEMPOOLS_H
 #define MEMPOOLS_H
 
+#include <stdarg.h> /* va_list */
+#include <stdint.h> /* uint32_t, uint64_t */
+
+/*
+ * Handles to pool items are 64 bits, or 32 if MEMHANDLE_32 is defined when
+ * compiling. They hold the item's index and the generation of its slot.
+ */
+#ifdef MEMHANDLE_32
+typedef uint32_t memhandle_t;
+/** The number of bits of a handle that hold the generation. */
+#define MEMHANDLE_GENERATION_BITS 8
+#else /* !MEMHANDLE_32 */
+typedef uint64_t memhandle_t;
+/** The number of bits of a handle that hold the generation. */
+#define MEMHANDLE_GENERATION_BITS 32
+#endif /* MEMHANDLE_32 */
+
+/** A handle that never refers to an item. */
+#define MEMHANDLE_NONE ((memhandle_t)0)
+
 /**
  * A bath holds items of fixed size. Items may be released and re-used or just
  * be feed when the bath is cleared/freed.
@@ -49,8 +69,18 @@ typedef struct membath{
 	size_t firstFree;
 	/** A bit-array of the slots in use. */
 	unsigned int * useMap;
+	/** The generation of each slot, counted up when its item is released. 
+	 *  NULL until a handle to one of the bath's items is handed out. */
+	uint32_t * generations;
+	/** A bit-array of the slots that mempool_compact may not move. NULL until
+	 *  one of the bath's items is pinned. */
+	unsigned int * pinMap;
+	/** A bit-array of the slots to keep at the next sweep, shaped like useMap. 
+	 *  NULL until one of the bath's items is marked. */
+	unsigned int * markMap;
 	
-	/** The slots. */
+	/** The slots. NULL while mempool_compact has freed them, until the pool
+	 *  needs the bath again. */
 	char * data;
 } membath_s;
 
@@ -58,17 +88,37 @@ typedef struct membath{
  * A pool manages a growing set of baths.
  */
 typedef struct mempool{
-	/** The number of baths. */
+	/** The number of baths in use. */
 	size_t length;
+	/** The number of baths, including the ones kept for re-use. */
+	size_t capacity;
+	/** The lowest indexed bath that may have free slots. */
+	size_t firstFree;
 	/** The size of the baths. */
 	size_t bathSize;
 	/** The size of the items. */
 	size_t itemSize;
+	/** The generation the slots of new baths start at: the highest of the
+	 *  baths freed by mempool_compact, so handles to them stay stale. */
+	uint32_t generation;
 	
 	/** The baths. */
 	membath_s * baths;
 } mempool_s;
 
+/**
+ * Called for each item or block of memory that is moved.
+ *
+ * @param ctx The context given along with the function.
+ * @param from The old location, still readable during the call.
+ * @param to The new location.
+ * @param size The size of what was moved.
+ */
+typedef void (*memrelocate_f)(void * ctx, void * from, void * to, size_t size);
+
+/** Returned by mempool_index for items not in the pool. */
+#define MEMPOOL_NONE ((size_t)-1)
+
 /**
  * A creek holds items of variable size. Items remain allocated as long as the
  * creek is.
@@ -78,24 +128,95 @@ typedef struct memcreek{
 	size_t size;
 	/** The occupied size. */
 	size_t length;
+	/** The number of items allocated and not released. */
+	size_t count;
+	/** The size occupied by scratch items, from the end of the creek down. */
+	size_t scratch;
 	
 	/** The memory. */
 	char * data;
 } memcreek_s;
 
 /**
- * A river manages a growing set of creeks.
+ * A lake holds a single item that is too large for a creek. The item follows
+ * the lake's header, which is padded to 16 bytes to keep the item aligned.
+ * Lakes are mapped directly from the system (where possible) and are kept 
+ * apart from the creeks.
+ */
+typedef struct memlake{
+	/** The next (older) lake. */
+	struct memlake * next;
+	/** The size of the lake, including this header. */
+	size_t size;
+	/** The number of lakes made in the river before this one. */
+	size_t number;
+} memlake_s;
+
+/**
+ * A cleanup function, see memriver_defer.
+ *
+ * @param arg The argument given along with the function.
+ */
+typedef void (*memdefer_f)(void * arg);
+
+/**
+ * A cleanup to run when the items of a river are released. Deferrals are
+ * allocated in the river's creeks.
+ */
+typedef struct memdefer{
+	/** The next (older) deferral. */
+	struct memdefer * next;
+	/** The function to run. */
+	memdefer_f fn;
+	/** The argument to pass. */
+	void * arg;
+} memdefer_s;
+
+/**
+ * A river manages a growing set of creeks, and a set of lakes for items that
+ * are too large for those creeks. Creeks are filled from both ends: regular 
+ * items from the start, and scratch items, which can be reset on their own, 
+ * from the end.
  */
 typedef struct memriver{
-	/** The number of creeks. */
+	/** The number of creeks in use. */
 	size_t length;
+	/** The number of creeks, including the ones kept for re-use. */
+	size_t capacity;
 	/** The size of the creeks. */
 	size_t creekSize;
+	/** The maximum size of adapting creeks, 0 if the creeks don't adapt. */
+	size_t creekMax;
 	
 	/** The creeks. */
 	memcreek_s * creeks;
+	/** The lakes, most recent first. */
+	memlake_s * lakes;
+	/** The number of lakes made since the river was last reset. */
+	size_t lakeCount;
+	/** The largest occupied size of the creeks seen at a reset or recycle. */
+	size_t peak;
+	/** The cleanups to run, most recent first. */
+	memdefer_s * defers;
+	/** The lakes of scratch items. */
+	memlake_s * scratchLakes;
 } memriver_s;
 
+/**
+ * A mark in a river that it can be rolled back to. The fields should be 
+ * considered private.
+ */
+typedef struct memmark{
+	/** The index of the last creek in use. */
+	size_t creek;
+	/** The occupied size of that creek. */
+	size_t length;
+	/** The number of lakes. */
+	size_t lakes;
+	/** The most recent deferral. */
+	memdefer_s * defers;
+} memmark_s;
+
 /**
  * Initialize a bath.
  * 
@@ -150,6 +271,14 @@ void * membath_alloc(membath_s * bath);
  * @return bath, or NULL if something went wrong.
  */
 membath_s * membath_release(membath_s * bath, void * vptr);
+/**
+ * Sweep a bath: release all items whose bit is not set in the bath's markMap,
+ * then clear the marks.
+ *
+ * @param bath The bath to sweep.
+ * @return bath.
+ */
+membath_s * membath_sweep(membath_s * bath);
 
 /**
  * Initialize a pool.
@@ -175,6 +304,14 @@ mempool_s * mempool_make(size_t bathSize, size_t itemSize);
  * @return pool, or NULL if something went wrong.
  */
 mempool_s * mempool_reset(mempool_s * pool);
+/**
+ * Recycle a pool: release all items, but keep all baths to be re-used by later
+ * allocations, instead of freeing all but one like mempool_reset.
+ *
+ * @param pool The pool to recycle.
+ * @return pool, or NULL if something went wrong.
+ */
+mempool_s * mempool_recycle(mempool_s * pool);
 /**
  * Clear a pool: clear all baths and invalidate the pool.
  *
@@ -189,7 +326,8 @@ mempool_s * mempool_clear(mempool_s * pool);
  */
 void mempool_free(mempool_s * pool);
 /**
- * Allocate an item from the pool.
+ * Allocate an item from the pool. Slots released in earlier baths are re-used
+ * before new baths are added.
  *
  * @param pool The pool to allocate from.
  * @return A pointer to an item, or NULL on error.
@@ -204,6 +342,123 @@ void * mempool_alloc(mempool_s * pool);
  * @return pool, or NULL on error.
  */
 mempool_s * mempool_release(mempool_s * pool, void * ptr);
+/**
+ * Get the index of an item in the pool: its slot counted over all baths. The
+ * index stays the same for as long as the item is allocated.
+ *
+ * @param pool The pool.
+ * @param ptr The item, obtained via mempool_alloc on pool.
+ * @return The index, or MEMPOOL_NONE if ptr is not in the pool.
+ */
+size_t mempool_index(mempool_s * pool, void * ptr);
+/**
+ * Allocate an item from the pool and get its index, see mempool_index.
+ *
+ * @param pool The pool to allocate from.
+ * @param index Set to the index of the item.
+ * @return A pointer to an item, or NULL on error.
+ */
+void * mempool_alloc_index(mempool_s * pool, size_t * index);
+/**
+ * Release an item back to the pool by its index, see mempool_index.
+ *
+ * @param pool The pool to release to.
+ * @param index The index of the item to release.
+ * @return pool, or NULL if index was not an allocated item.
+ */
+mempool_s * mempool_release_index(mempool_s * pool, size_t index);
+/**
+ * Pin an item, so mempool_compact won't move it. Releasing the item unpins it.
+ *
+ * @param pool The pool.
+ * @param ptr The item, obtained via mempool_alloc on pool.
+ * @return pool, or NULL if ptr is not an allocated item of pool.
+ */
+mempool_s * mempool_pin(mempool_s * pool, void * ptr);
+/**
+ * Unpin an item, see mempool_pin.
+ *
+ * @param pool The pool.
+ * @param ptr The item, obtained via mempool_alloc on pool.
+ * @return pool, or NULL if ptr is not an allocated item of pool.
+ */
+mempool_s * mempool_unpin(mempool_s * pool, void * ptr);
+/**
+ * Compact a pool: move the items of the last baths into the free slots of the
+ * baths before them, where they fit, and free the storage of the baths that 
+ * end up empty (as well as those kept by mempool_recycle). A bath with a 
+ * pinned item is not emptied, but the baths before it still are. The baths 
+ * keep their place, so items that were not moved keep their pointers, indices
+ * and handles; handles to moved items go stale, and stay so when the pool 
+ * grows again. Marks for mempool_sweep move with their items.
+ *
+ * @param pool The pool to compact.
+ * @param relocate Called for every item that is moved, may be NULL.
+ * @param ctx Passed to relocate.
+ * @return pool, or NULL on error.
+ */
+mempool_s * mempool_compact(mempool_s * pool, memrelocate_f relocate,
+		void * ctx);
+/**
+ * Mark an item to be kept by the next mempool_sweep.
+ *
+ * @param pool The pool.
+ * @param ptr The item, obtained via mempool_alloc on pool.
+ * @return pool, or NULL if ptr is not an allocated item of pool.
+ */
+mempool_s * mempool_mark(mempool_s * pool, void * ptr);
+/**
+ * Mark an item to be kept by the next mempool_sweep, by index. Cheaper than
+ * mempool_mark, which has to find the item's bath.
+ *
+ * @param pool The pool.
+ * @param index The item's index, see mempool_index.
+ * @return pool, or NULL if index is not an allocated item of pool.
+ */
+mempool_s * mempool_mark_index(mempool_s * pool, size_t index);
+/**
+ * Sweep a pool: release all items that were not marked since the last sweep,
+ * in one pass over the bit-arrays, and clear the marks.
+ *
+ * @param pool The pool to sweep.
+ * @return pool.
+ */
+mempool_s * mempool_sweep(mempool_s * pool);
+/**
+ * Allocate an item from the pool and get a handle to it. The handle holds the
+ * item's index and the generation of its slot, which goes up every time an
+ * item in that slot is released (by any means), so handles to released items
+ * are detected. Handles become invalid when the pool is reset or cleared.
+ *
+ * @param pool The pool to allocate from.
+ * @param handle Set to the handle of the item.
+ * @return A pointer to an item, or NULL on error.
+ */
+void * mempool_alloc_handle(mempool_s * pool, memhandle_t * handle);
+/**
+ * Get the item a handle refers to.
+ *
+ * @param pool The pool.
+ * @param handle The handle, obtained via mempool_alloc_handle on pool.
+ * @return A pointer to the item, or NULL if it has been released.
+ */
+void * mempool_deref(mempool_s * pool, memhandle_t handle);
+/**
+ * Release an item back to the pool by its handle.
+ *
+ * @param pool The pool to release to.
+ * @param handle The handle, obtained via mempool_alloc_handle on pool.
+ * @return pool, or NULL if the item has already been released.
+ */
+mempool_s * mempool_release_handle(mempool_s * pool, memhandle_t handle);
+/**
+ * Get the item at an index in the pool, see mempool_index.
+ *
+ * @param pool The pool.
+ * @param index The index, must be in one of the pool's baths.
+ * @return The item.
+ */
+void * mempool_at(mempool_s * pool, size_t index);
 
 /**
  * Initialize a creek.
@@ -227,6 +482,13 @@ memcreek_s * memcreek_make(size_t size);
  * @return creek, or NULL if something went wrong.
  */
 memcreek_s * memcreek_reset(memcreek_s * creek);
+/**
+ * Reset the scratch end of a creek: all scratch items become invalid.
+ *
+ * @param creek The creek to reset.
+ * @return creek.
+ */
+memcreek_s * memcreek_reset_scratch(memcreek_s * creek);
 /**
  * De-initialize a creek: release all items and invalidate storage.
  *
@@ -248,6 +510,24 @@ void memcreek_free(memcreek_s * creek);
  * @return A pointer to an item, or NULL on error.
  */
 void * memcreek_alloc(memcreek_s * creek, size_t sz);
+/**
+ * Allocate an aligned item from the creek. The space skipped to align the item
+ * remains in use.
+ *
+ * @param creek The creek to allocate from.
+ * @param sz The size of the item to allocate.
+ * @param align The alignment of the item, a power of 2.
+ * @return A pointer to an item, or NULL on error.
+ */
+void * memcreek_alloc_aligned(memcreek_s * creek, size_t sz, size_t align);
+/**
+ * Allocate a scratch item from the end of the creek.
+ *
+ * @param creek The creek to allocate from.
+ * @param sz The size of the item to allocate.
+ * @return A pointer to an item, or NULL on error.
+ */
+void * memcreek_alloc_scratch(memcreek_s * creek, size_t sz);
 
 /**
  * Initialize a river.
@@ -264,10 +544,24 @@ memriver_s * memriver_init(memriver_s * riv, size_t creekSize);
  * @return An initialized creek, or NULL on error.
  */
 memriver_s * memriver_make(size_t creekSize);
+/**
+ * Make the creeks of a river adapt to its usage: every new creek is twice the
+ * size of the previous one, up to creekMax, and on reset the first creek is
+ * grown to fit the most that was in use at any reset (also up to creekMax).
+ * Items up to creekMax get a creek, only larger items go into lakes. Should be
+ * called before anything is allocated from the river.
+ *
+ * @param riv The river to adapt.
+ * @param creekMax The maximum size of the creeks, at least the creekSize the 
+ *                 river was initialized with.
+ * @return riv.
+ */
+memriver_s * memriver_adapt(memriver_s * riv, size_t creekMax);
 /**
  * Allocate an item from the river. The requested size may be larger than the 
- * size of the creeks in this river, in which case 1 new bath will be allocated
- * to fit the requested item exactly.
+ * size of the creeks in this river (or the maximum size if the river adapts),
+ * in which case 1 new lake will be mapped to fit the requested item exactly.
+ * Lakes are not part of the creeks, so they don't slow down later allocations.
  * 
  * @param riv The river to allocate from.
  * @param size The size of the item to allocate.
@@ -275,12 +569,181 @@ memriver_s * memriver_make(size_t creekSize);
  */
 void * memriver_alloc(memriver_s * riv, size_t size);
 /**
- * Reset a river: clear all creeks to 1 and reset the remaining one.
+ * Allocate an aligned item from the river, see memriver_alloc. Aligned items
+ * should not be resized with memriver_realloc.
+ *
+ * @param riv The river to allocate from.
+ * @param size The size of the item to allocate.
+ * @param align The alignment of the item, a power of 2.
+ * @return An item, or NULL on error.
+ */
+void * memriver_alloc_aligned(memriver_s * riv, size_t size, size_t align);
+/**
+ * Allocate a scratch item from the river. Scratch items are taken from the end
+ * of the creeks, so they share creeks with the regular items but can be 
+ * released on their own with memriver_reset_scratch. Items too large for a 
+ * creek get a lake, like with memriver_alloc. Scratch items cannot be resized
+ * or released one by one, and don't survive memriver_flatten. A rollback only
+ * releases the scratch items in the creeks it drops.
+ *
+ * @param riv The river to allocate from.
+ * @param size The size of the item to allocate.
+ * @return An item, or NULL on error.
+ */
+void * memriver_alloc_scratch(memriver_s * riv, size_t size);
+/**
+ * Resize an item allocated from the river. If the item is the most recently
+ * allocated one in its creek and the creek has room, the item is grown (or 
+ * shrunk) in place. Otherwise a new item is allocated and the contents are
+ * copied over. The space of the old item is given back to the river if it was
+ * on top of its creek or in a lake, otherwise it remains in use as long as the
+ * river does.
+ *
+ * @param riv The river to allocate from.
+ * @param ptr The item to resize, must have been obtained from riv, or NULL to
+ *            allocate a new item.
+ * @param oldSize The size with which ptr was allocated (or last resized).
+ * @param size The new size of the item.
+ * @return The resized item (which may or may not be ptr), or NULL on error, in
+ *         which case ptr is left untouched.
+ */
+void * memriver_realloc(memriver_s * riv, void * ptr, size_t oldSize,
+		size_t size);
+/**
+ * Allocate a copy of a block of memory from the river.
+ *
+ * @param riv The river to allocate from.
+ * @param src The memory to copy.
+ * @param size The size of the memory to copy, in bytes.
+ * @return The copy, or NULL on error.
+ */
+void * memriver_memdup(memriver_s * riv, const void * src, size_t size);
+/**
+ * Allocate a copy of a string from the river.
+ *
+ * @param riv The river to allocate from.
+ * @param str The nul-terminated string to copy.
+ * @return The copy, or NULL on error.
+ */
+char * memriver_strdup(memriver_s * riv, const char * str);
+/**
+ * Allocate a copy of at most n characters of a string from the river. The 
+ * copy is always nul-terminated.
+ *
+ * @param riv The river to allocate from.
+ * @param str The string to copy.
+ * @param n The maximum number of characters to copy.
+ * @return The copy, or NULL on error.
+ */
+char * memriver_strndup(memriver_s * riv, const char * str, size_t n);
+/**
+ * Allocate a formatted string from the river. The string is formatted directly
+ * into the free space of the last creek and takes up exactly as much as it 
+ * needs. Only if it doesn't fit is it formatted again into a new item.
+ *
+ * @param riv The river to allocate from.
+ * @param fmt The printf-style format.
+ * @param args The arguments for the format.
+ * @return The formatted string, or NULL on error.
+ */
+char * memriver_vprintf(memriver_s * riv, const char * fmt, va_list args);
+/**
+ * Allocate a formatted string from the river, see memriver_vprintf.
+ *
+ * @param riv The river to allocate from.
+ * @param fmt The printf-style format.
+ * @param ... The arguments for the format.
+ * @return The formatted string, or NULL on error.
+ */
+char * memriver_printf(memriver_s * riv, const char * fmt, ...);
+/**
+ * Release an item from a river. Every creek counts the items allocated from it
+ * (memriver_realloc counts a moved item as released), and a creek whose items
+ * have all been released is reset in its place, for later allocations to fill
+ * again; it keeps its index, so marks stay valid. An item in a lake of its own
+ * unmaps the lake. Creeks that had items rolled back are only reclaimed at a 
+ * reset.
+ *
+ * @param riv The river.
+ * @param ptr The item, allocated from riv and not yet released.
+ * @return riv, or NULL if ptr is not an item of riv.
+ */
+memriver_s * memriver_release(memriver_s * riv, void * ptr);
+/**
+ * Defer a cleanup until the river's items are released: fn(arg) is run when
+ * the river is reset, recycled, cleared or freed, or rolled back to a mark 
+ * made before the deferral. Cleanups run most recent first, before any memory
+ * is released, so arg may be an item of the river.
+ *
+ * @param riv The river.
+ * @param fn The cleanup function.
+ * @param arg The argument to pass to fn.
+ * @return riv, or NULL on error (in which case fn will not be run).
+ */
+memriver_s * memriver_defer(memriver_s * riv, memdefer_f fn, void * arg);
+/**
+ * Mark the current state of a river, to roll back to later.
+ *
+ * @param riv The river to mark.
+ * @return The mark.
+ */
+memmark_s memriver_mark(memriver_s * riv);
+/**
+ * Roll a river back to a mark: all items allocated since the mark become
+ * invalid. Creeks added since the mark are either cleared, or kept to be 
+ * re-used by later allocations. Items that were allocated after the mark in 
+ * the remaining space of older creeks are not released. Marks made after the
+ * given mark become invalid, as do all marks when the river is reset.
+ *
+ * @param riv The river to roll back.
+ * @param mark The mark to roll back to, obtained from memriver_mark on riv.
+ * @param keep Whether to keep the creeks added since the mark for re-use.
+ * @return riv, or NULL if mark is not valid for riv.
+ */
+memriver_s * memriver_rollback(memriver_s * riv, memmark_s mark, int keep);
+/**
+ * Reset a river: clear all creeks to 1, reset the remaining one and unmap all
+ * lakes. If the river adapts, the remaining creek is grown to fit the peak.
  *
  * @param riv The river to reset.
  * @return riv, or NULL on error.
  */
 memriver_s * memriver_reset(memriver_s * riv);
+/**
+ * Release all scratch items of a river, and unmap their lakes. Regular items
+ * are left alone.
+ *
+ * @param riv The river.
+ * @return riv.
+ */
+memriver_s * memriver_reset_scratch(memriver_s * riv);
+/**
+ * Recycle a river: release all items, but keep all creeks to be re-used by
+ * later allocations, instead of freeing all but one like memriver_reset. Lakes
+ * are unmapped. Optionally the creeks are coalesced into a single creek big
+ * enough for the most that was ever in use at a recycle, so the next round 
+ * fits in one contiguous creek.
+ *
+ * @param riv The river to recycle.
+ * @param coalesce Whether to coalesce the creeks into one.
+ * @return riv, or NULL on error.
+ */
+memriver_s * memriver_recycle(memriver_s * riv, int coalesce);
+/**
+ * Flatten a river: copy the occupied part of every creek into a single new
+ * creek, one after the other, and free the old creeks. Where possible the new
+ * creek is backed by huge pages. Alignments of up to 64 bytes are kept; lakes
+ * are not moved. Deferrals, and their arguments if they are in the river, are
+ * moved along. Marks made before flattening become invalid.
+ *
+ * @param riv The river to flatten.
+ * @param relocate Called once per creek that is moved, with its old and new
+ *                 location and its occupied size, may be NULL.
+ * @param ctx Passed to relocate.
+ * @return riv, or NULL on error (in which case riv is left as it was).
+ */
+memriver_s * memriver_flatten(memriver_s * riv, memrelocate_f relocate,
+		void * ctx);
 /**
  * De-initialize a river: release all items and invalidate the storage.
  *
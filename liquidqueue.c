@@ -0,0 +1,167 @@
+/**
+ * LiquidMem: lock-free queues.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidqueue.c
+ *
+ * See README.md for quick-start info and liquidqueue.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "liquidmem.h"
+#include "liquidqueue.h"
+
+#ifndef __GNUC__
+#error "liquidqueue.c needs GCC-style __atomic builtins"
+#endif
+
+#define loadRelaxed(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define loadAcquire(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define storeRelease(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+/* On failure, expected is updated to the current value. */
+#define casRelaxed(ptr, expected, desired)                                     \
+		__atomic_compare_exchange_n(ptr, expected, desired, 1,                 \
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED)
+
+/* 
+ * Cell i is ready for the push at position p when its sequence number is p,
+ * and for the pop at position p when it is p + 1. A pop then sets it to the 
+ * position of the push one lap later.
+ */
+
+static size_t * cellSeq(memqueue_s * q, size_t pos){
+	return (size_t *)(q->cells + (pos & (q->size - 1)) * q->cellSize);
+}
+
+static char * cellItem(size_t * seq){
+	return (char *)(seq + 1);
+}
+
+memqueue_s * memqueue_init(memqueue_s * q, size_t size, size_t itemSize){
+	// with 1 cell, a full cell would look ready for the next push
+	q->size = 2;
+	while(q->size < size){
+		q->size *= 2;
+	}
+	
+	// keep the sequence numbers aligned
+	q->itemSize = itemSize;
+	q->cellSize = sizeof(size_t) + 
+			(itemSize + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+	
+	q->cells = malloc(q->size * q->cellSize);
+	if(!q->cells){
+		return NULL;
+	}
+	
+	for(size_t i = 0; i < q->size; i++){
+		*cellSeq(q, i) = i;
+	}
+	q->head = 0;
+	q->tail = 0;
+	
+	return q;
+}
+
+memqueue_s * memqueue_make(size_t size, size_t itemSize){
+	memqueue_s * ret = malloc(sizeof *ret);
+	if(!ret){
+		return NULL;
+	}
+	
+	return memqueue_init(ret, size, itemSize);
+}
+
+memqueue_s * memqueue_clear(memqueue_s * q){
+	free(q->cells);
+	q->cells = NULL;
+	q->head = 0;
+	q->tail = 0;
+	
+	return q;
+}
+
+void memqueue_free(memqueue_s * q){
+	memqueue_clear(q);
+	free(q);
+}
+
+memqueue_s * memqueue_push(memqueue_s * q, const void * item){
+	size_t pos = loadRelaxed(&q->head);
+	size_t * seq;
+	
+	for(;;){
+		seq = cellSeq(q, pos);
+		ptrdiff_t dif = (ptrdiff_t)(loadAcquire(seq) - pos);
+		
+		if(dif == 0){
+			if(casRelaxed(&q->head, &pos, pos + 1)){
+				break;
+			}
+		}else if(dif < 0){
+			// the cell still holds the item from a lap ago: full
+			return NULL;
+		}else{
+			// another producer got here first
+			pos = loadRelaxed(&q->head);
+		}
+	}
+	
+	memcpy(cellItem(seq), item, q->itemSize);
+	storeRelease(seq, pos + 1);
+	
+	return q;
+}
+
+memqueue_s * memqueue_pop(memqueue_s * q, void * item){
+	size_t pos = loadRelaxed(&q->tail);
+	size_t * seq;
+	
+	for(;;){
+		seq = cellSeq(q, pos);
+		ptrdiff_t dif = (ptrdiff_t)(loadAcquire(seq) - (pos + 1));
+		
+		if(dif == 0){
+			if(casRelaxed(&q->tail, &pos, pos + 1)){
+				break;
+			}
+		}else if(dif < 0){
+			// the cell hasn't been pushed to yet: empty
+			return NULL;
+		}else{
+			// another consumer got here first
+			pos = loadRelaxed(&q->tail);
+		}
+	}
+	
+	memcpy(item, cellItem(seq), q->itemSize);
+	storeRelease(seq, pos + q->size);
+	
+	return q;
+}
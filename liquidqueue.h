@@ -0,0 +1,122 @@
+/**
+ * LiquidMem: lock-free queues.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidqueue.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDQUEUE_H
+#define LIQUIDQUEUE_H
+
+#include "liquidmem.h"
+
+/** The assumed size of a cache line, to keep the ends of a queue apart. */
+#define MEMQUEUE_LINE 64
+
+/**
+ * A queue passes items of fixed size from any number of threads to any number
+ * of threads, without locks. It is bounded: the items are copied into a ring of
+ * cells that is allocated once, and each cell carries a sequence number that
+ * tells producers and consumers whose turn it is. Cells are re-used in place, 
+ * so nothing is allocated or reclaimed while the queue is in use.
+ *
+ * Needs GCC-style __atomic builtins.
+ */
+typedef struct memqueue{
+	/** The number of cells, a power of 2. */
+	size_t size;
+	/** The size of the items. */
+	size_t itemSize;
+	/** The size of the cells: a sequence number followed by an item. */
+	size_t cellSize;
+	/** The cells. */
+	char * cells;
+	
+	/** @private Keeps head on a cache line of its own. */
+	char pad0[MEMQUEUE_LINE];
+	/** The position of the next push. */
+	size_t head;
+	/** @private Keeps tail on a cache line of its own. */
+	char pad1[MEMQUEUE_LINE - sizeof(size_t)];
+	/** The position of the next pop. */
+	size_t tail;
+	/** @private Keeps tail on a cache line of its own. */
+	char pad2[MEMQUEUE_LINE - sizeof(size_t)];
+} memqueue_s;
+
+/**
+ * Initialize a queue. Not thread-safe.
+ *
+ * @param q The queue to initialize.
+ * @param size The number of items the queue can hold, rounded up to a power of
+ *             2, and at least 2.
+ * @param itemSize The size of the items.
+ * @return q if successful, NULL on error.
+ */
+memqueue_s * memqueue_init(memqueue_s * q, size_t size, size_t itemSize);
+/**
+ * Malloc and initialize a queue. Not thread-safe.
+ *
+ * @param size The number of items the queue can hold, rounded up to a power of
+ *             2, and at least 2.
+ * @param itemSize The size of the items.
+ * @return An initialized queue, or NULL on error.
+ */
+memqueue_s * memqueue_make(size_t size, size_t itemSize);
+/**
+ * De-initialize a queue: drop all items and invalidate the storage. Not 
+ * thread-safe.
+ *
+ * @param q The queue to clear.
+ * @return q.
+ */
+memqueue_s * memqueue_clear(memqueue_s * q);
+/**
+ * Clear and free a queue that was made with memqueue_make. Not thread-safe.
+ *
+ * @param q The queue to free, must have been obtained with memqueue_make.
+ */
+void memqueue_free(memqueue_s * q);
+/**
+ * Copy an item onto the end of the queue. Thread-safe.
+ *
+ * @param q The queue.
+ * @param item The item to copy.
+ * @return q, or NULL if the queue is full.
+ */
+memqueue_s * memqueue_push(memqueue_s * q, const void * item);
+/**
+ * Copy the item at the front of the queue out and remove it. Thread-safe.
+ *
+ * @param q The queue.
+ * @param item Where to copy the item to.
+ * @return q, or NULL if the queue is empty.
+ */
+memqueue_s * memqueue_pop(memqueue_s * q, void * item);
+
+#endif /* LIQUIDQUEUE_H */
@@ -0,0 +1,166 @@
+/**
+ * LiquidMem: first-in first-out rings of variable-size records.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidring.c
+ *
+ * See README.md for quick-start info and liquidring.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+
+#include "liquidmem.h"
+#include "liquidring.h"
+
+/* The header before each record. */
+typedef struct memrecord{
+	size_t size;
+} memrecord_s;
+
+/* Round up to the alignment, 0 on overflow. */
+static size_t alignUp(size_t size){
+	size_t ret = (size + MEMRING_ALIGN - 1) & ~(size_t)(MEMRING_ALIGN - 1);
+	
+	return ret < size ? 0 : ret;
+}
+
+#define HEADER_SIZE alignUp(sizeof(memrecord_s))
+
+/* The space a record takes up, header included, 0 on overflow. */
+static size_t recordSpan(size_t size){
+	size_t span = alignUp(size);
+	
+	return span && span + HEADER_SIZE > span ? span + HEADER_SIZE : 0;
+}
+
+static memrecord_s * recordAt(memring_s * ring, size_t offset){
+	return (memrecord_s *)(ring->creek.data + offset);
+}
+
+memring_s * memring_init(memring_s * ring, size_t size){
+	size_t span = alignUp(size);
+	if(!span){
+		return NULL;
+	}
+	
+	if(!memcreek_init(&ring->creek, span)){
+		return NULL;
+	}
+	
+	return memring_reset(ring);
+}
+
+memring_s * memring_make(size_t size){
+	memring_s * ret = malloc(sizeof *ret);
+	
+	if(!ret){
+		return NULL;
+	}
+	
+	return memring_init(ret, size);
+}
+
+memring_s * memring_reset(memring_s * ring){
+	ring->length = 0;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->wrap = 0;
+	
+	return ring;
+}
+
+memring_s * memring_clear(memring_s * ring){
+	memcreek_clear(&ring->creek);
+	
+	return memring_reset(ring);
+}
+
+void memring_free(memring_s * ring){
+	memring_clear(ring);
+	free(ring);
+}
+
+void * memring_alloc(memring_s * ring, size_t size){
+	size_t span = recordSpan(size);
+	if(!span){
+		return NULL;
+	}
+	
+	if(ring->wrap){
+		// between the head at the bottom and the tail above it
+		if(ring->tail - ring->head < span){
+			return NULL;
+		}
+	}else if(ring->creek.size - ring->head < span){
+		// no room at the top: wrap around if the bottom is free enough
+		if(ring->tail < span){
+			return NULL;
+		}
+		
+		ring->wrap = ring->head;
+		ring->head = 0;
+	}
+	
+	memrecord_s * rec = recordAt(ring, ring->head);
+	rec->size = size;
+	
+	ring->head += span;
+	ring->length++;
+	
+	return (char *)rec + HEADER_SIZE;
+}
+
+void * memring_oldest(memring_s * ring, size_t * size){
+	if(!ring->length){
+		return NULL;
+	}
+	
+	memrecord_s * rec = recordAt(ring, ring->tail);
+	if(size){
+		*size = rec->size;
+	}
+	
+	return (char *)rec + HEADER_SIZE;
+}
+
+memring_s * memring_release(memring_s * ring){
+	if(!ring->length){
+		return NULL;
+	}
+	
+	// start over at the bottom when empty, for the most room in one piece
+	if(!--ring->length){
+		return memring_reset(ring);
+	}
+	
+	ring->tail += recordSpan(recordAt(ring, ring->tail)->size);
+	if(ring->wrap && ring->tail == ring->wrap){
+		ring->tail = 0;
+		ring->wrap = 0;
+	}
+	
+	return ring;
+}
@@ -0,0 +1,125 @@
+/**
+ * LiquidMem: first-in first-out rings of variable-size records.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidring.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDRING_H
+#define LIQUIDRING_H
+
+#include "liquidmem.h"
+
+/** The alignment of the records, and of their headers. */
+#define MEMRING_ALIGN 16
+
+/**
+ * A ring allocates records of any size from the head of a single creek, and 
+ * releases them strictly in the same order from its tail. When the head 
+ * reaches the end of the creek it wraps around to the start, as soon as the 
+ * tail has made room there, so the creek is re-used without ever being reset.
+ * Every record is preceded by a header holding its size.
+ */
+typedef struct memring{
+	/** The number of records. */
+	size_t length;
+	/** The offset at which the next record goes. */
+	size_t head;
+	/** The offset of the oldest record. */
+	size_t tail;
+	/** The end of the records at the top of the creek once the head has 
+	 *  wrapped around, 0 while it hasn't. */
+	size_t wrap;
+	
+	/** The memory. Only its size and data are used. */
+	memcreek_s creek;
+} memring_s;
+
+/**
+ * Initialize a ring.
+ *
+ * @param ring The ring to initialize.
+ * @param size The size of the ring's creek, in bytes, rounded up to 
+ *             MEMRING_ALIGN. Every record takes up its size plus a header, 
+ *             both rounded up to MEMRING_ALIGN.
+ * @return ring if successful, NULL on error.
+ */
+memring_s * memring_init(memring_s * ring, size_t size);
+/**
+ * Malloc and initialize a ring.
+ *
+ * @param size The size of the ring's creek, see memring_init.
+ * @return An initialized ring, or NULL on error.
+ */
+memring_s * memring_make(size_t size);
+/**
+ * Reset a ring: release all records.
+ *
+ * @param ring The ring to reset.
+ * @return ring.
+ */
+memring_s * memring_reset(memring_s * ring);
+/**
+ * De-initialize a ring: release all records and invalidate the storage.
+ *
+ * @param ring The ring to clear.
+ * @return ring.
+ */
+memring_s * memring_clear(memring_s * ring);
+/**
+ * Clear and free a ring that was made with memring_make.
+ *
+ * @param ring The ring to free, must have been obtained with memring_make.
+ */
+void memring_free(memring_s * ring);
+/**
+ * Allocate a record at the head of the ring.
+ *
+ * @param ring The ring to allocate from.
+ * @param size The size of the record.
+ * @return The record, aligned to MEMRING_ALIGN, or NULL if there is no room 
+ *         for it until older records are released.
+ */
+void * memring_alloc(memring_s * ring, size_t size);
+/**
+ * Get the oldest record of the ring, the next to be released.
+ *
+ * @param ring The ring.
+ * @param size Set to the size of the record, may be NULL.
+ * @return The record, or NULL if the ring is empty.
+ */
+void * memring_oldest(memring_s * ring, size_t * size);
+/**
+ * Release the oldest record of the ring.
+ *
+ * @param ring The ring.
+ * @return ring, or NULL if the ring is empty.
+ */
+memring_s * memring_release(memring_s * ring);
+
+#endif /* LIQUIDRING_H */
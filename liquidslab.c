@@ -0,0 +1,251 @@
+/**
+ * LiquidMem: size-class allocators made of pools.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidslab.c
+ *
+ * See README.md for quick-start info and liquidslab.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#if !defined(NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define USE_MMAP
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS */
+#endif
+
+#include <stdlib.h>
+#include <limits.h>
+
+#ifdef USE_MMAP
+#include <sys/mman.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif /* USE_MMAP */
+
+#include "liquidmem.h"
+#include "liquidslab.h"
+
+/* The header of large items, rounded up to keep the items aligned. */
+#define LARGE_HEADER ((sizeof(memslablarge_s) + 15) & ~(size_t)15)
+
+/* Index of the highest set bit in a non-zero size. */
+static unsigned int highestBit(size_t size){
+#ifdef __GNUC__
+	return sizeof(unsigned long long) * CHAR_BIT - 1 - 
+			__builtin_clzll((unsigned long long)size);
+#else /* !__GNUC__ */
+	unsigned int i = 0;
+	while(size >>= 1){
+		i++;
+	}
+	
+	return i;
+#endif /* __GNUC__ */
+}
+
+/* The class of a size up to MEMSLAB_MAX. */
+static size_t classOf(size_t size){
+	if(size <= 128){
+		return size ? (size - 1) / 16 : 0;
+	}
+	
+	// 4 classes per doubling: the top 3 bits of size - 1 pick one
+	size_t top = size - 1;
+	unsigned int bit = highestBit(top);
+	
+	return 8 + (bit - 7) * 4 + (top >> (bit - 2)) - 4;
+}
+
+/* The item size of a class. */
+static size_t classSize(size_t cls){
+	if(cls < 8){
+		return (cls + 1) * 16;
+	}
+	
+	cls -= 8;
+	return (cls % 4 + 5) << (cls / 4 + 5);
+}
+
+memslab_s * memslab_init(memslab_s * slab){
+	for(size_t i = 0; i < MEMSLAB_CLASSES; i++){
+		slab->pools[i] = NULL;
+	}
+	slab->large = NULL;
+	
+	return slab;
+}
+
+memslab_s * memslab_make(void){
+	memslab_s * ret = malloc(sizeof *ret);
+	
+	if(!ret){
+		return NULL;
+	}
+	
+	return memslab_init(ret);
+}
+
+static void unmapLarge(memslablarge_s * large){
+#ifdef USE_MMAP
+	munmap(large, large->size);
+#else /* !USE_MMAP */
+	free(large);
+#endif /* USE_MMAP */
+}
+
+static void unmapAll(memslab_s * slab){
+	while(slab->large){
+		memslablarge_s * next = slab->large->next;
+		unmapLarge(slab->large);
+		slab->large = next;
+	}
+}
+
+memslab_s * memslab_reset(memslab_s * slab){
+	unmapAll(slab);
+	
+	for(size_t i = 0; i < MEMSLAB_CLASSES; i++){
+		if(slab->pools[i] && !mempool_reset(slab->pools[i])){
+			return NULL;
+		}
+	}
+	
+	return slab;
+}
+
+memslab_s * memslab_clear(memslab_s * slab){
+	unmapAll(slab);
+	
+	for(size_t i = 0; i < MEMSLAB_CLASSES; i++){
+		if(slab->pools[i]){
+			mempool_free(slab->pools[i]);
+			slab->pools[i] = NULL;
+		}
+	}
+	
+	return slab;
+}
+
+void memslab_free(memslab_s * slab){
+	memslab_clear(slab);
+	free(slab);
+}
+
+size_t memslab_size(size_t size){
+	return size > MEMSLAB_MAX ? size : classSize(classOf(size));
+}
+
+static void * allocLarge(memslab_s * slab, size_t size){
+	size_t total = LARGE_HEADER + size;
+	if(total < size){
+		return NULL;
+	}
+	
+#ifdef USE_MMAP
+	memslablarge_s * large = mmap(NULL, total, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(large == MAP_FAILED){
+		return NULL;
+	}
+#else /* !USE_MMAP */
+	memslablarge_s * large = malloc(total);
+	if(!large){
+		return NULL;
+	}
+#endif /* USE_MMAP */
+	
+	large->size = total;
+	large->prev = NULL;
+	large->next = slab->large;
+	if(slab->large){
+		slab->large->prev = large;
+	}
+	slab->large = large;
+	
+	return (char *)large + LARGE_HEADER;
+}
+
+static void releaseLarge(memslab_s * slab, memslablarge_s * large){
+	if(large->prev){
+		large->prev->next = large->next;
+	}else{
+		slab->large = large->next;
+	}
+	if(large->next){
+		large->next->prev = large->prev;
+	}
+	
+	unmapLarge(large);
+}
+
+void * memslab_alloc(memslab_s * slab, size_t size){
+	if(size > MEMSLAB_MAX){
+		return allocLarge(slab, size);
+	}
+	
+	size_t cls = classOf(size);
+	if(!slab->pools[cls]){
+		size_t itemSize = classSize(cls);
+		slab->pools[cls] = mempool_make(MEMSLAB_BATH / itemSize, itemSize);
+		if(!slab->pools[cls]){
+			return NULL;
+		}
+	}
+	
+	return mempool_alloc(slab->pools[cls]);
+}
+
+memslab_s * memslab_release(memslab_s * slab, void * ptr, size_t size){
+	if(!ptr){
+		return NULL;
+	}
+	
+	if(size > MEMSLAB_MAX){
+		releaseLarge(slab, (memslablarge_s *)((char *)ptr - LARGE_HEADER));
+		return slab;
+	}
+	
+	if(size){
+		mempool_s * pool = slab->pools[classOf(size)];
+		return pool && mempool_release(pool, ptr) ? slab : NULL;
+	}
+	
+	// size unknown: try every class, then the large items
+	for(size_t i = 0; i < MEMSLAB_CLASSES; i++){
+		if(slab->pools[i] && mempool_release(slab->pools[i], ptr)){
+			return slab;
+		}
+	}
+	
+	for(memslablarge_s * large = slab->large; large; large = large->next){
+		if((char *)large + LARGE_HEADER == ptr){
+			releaseLarge(slab, large);
+			return slab;
+		}
+	}
+	
+	return NULL;
+}
@@ -0,0 +1,131 @@
+/**
+ * LiquidMem: size-class allocators made of pools.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidslab.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDSLAB_H
+#define LIQUIDSLAB_H
+
+#include "liquidmem.h"
+
+/** The largest size served by a pool, larger items are mapped one by one. */
+#define MEMSLAB_MAX 4096
+/** The number of size classes: multiples of 16 up to 128, then 4 classes per
+ *  doubling up to MEMSLAB_MAX. */
+#define MEMSLAB_CLASSES 28
+/** The approximate size of a bath, in bytes. */
+#define MEMSLAB_BATH 65536
+
+/**
+ * A large item, mapped on its own, is preceded by this header. 
+ */
+typedef struct memslablarge{
+	/** The previous large item. */
+	struct memslablarge * prev;
+	/** The next large item. */
+	struct memslablarge * next;
+	/** The size of the mapping, including this header. */
+	size_t size;
+} memslablarge_s;
+
+/**
+ * A slab allocates items of any size. Sizes up to MEMSLAB_MAX are rounded up 
+ * to one of a set of size classes, and each class has a pool of its own, whose
+ * baths hold about MEMSLAB_BATH bytes. The pools are made when their class is
+ * first used. Larger items are mapped from the system (where possible) one by
+ * one. All items are aligned to 16 bytes.
+ */
+typedef struct memslab{
+	/** The pools of the size classes, NULL until used. */
+	mempool_s * pools[MEMSLAB_CLASSES];
+	/** The large items. */
+	memslablarge_s * large;
+} memslab_s;
+
+/**
+ * Initialize a slab.
+ *
+ * @param slab The slab to initialize.
+ * @return slab.
+ */
+memslab_s * memslab_init(memslab_s * slab);
+/**
+ * Malloc and initialize a slab.
+ *
+ * @return An initialized slab, or NULL on error.
+ */
+memslab_s * memslab_make(void);
+/**
+ * Reset a slab: release all items, keeping one bath per pool.
+ *
+ * @param slab The slab to reset.
+ * @return slab, or NULL on error.
+ */
+memslab_s * memslab_reset(memslab_s * slab);
+/**
+ * De-initialize a slab: release all items and free the pools.
+ *
+ * @param slab The slab to clear.
+ * @return slab.
+ */
+memslab_s * memslab_clear(memslab_s * slab);
+/**
+ * Clear and free a slab that was made with memslab_make.
+ *
+ * @param slab The slab to free, must have been obtained with memslab_make.
+ */
+void memslab_free(memslab_s * slab);
+/**
+ * Get the size that is actually allocated for an item of a given size.
+ *
+ * @param size The requested size.
+ * @return The size of its class, or size itself for large items.
+ */
+size_t memslab_size(size_t size);
+/**
+ * Allocate an item from the slab.
+ *
+ * @param slab The slab to allocate from.
+ * @param size The size of the item.
+ * @return The item, or NULL on error.
+ */
+void * memslab_alloc(memslab_s * slab, size_t size);
+/**
+ * Release an item back to the slab.
+ *
+ * @param slab The slab to release to.
+ * @param ptr The item, obtained via memslab_alloc on slab.
+ * @param size The size the item was allocated with, or 0 if it isn't known. 
+ *             Then the pools of all classes have to be searched for ptr.
+ * @return slab, or NULL if ptr is not an item of slab.
+ */
+memslab_s * memslab_release(memslab_s * slab, void * ptr, size_t size);
+
+#endif /* LIQUIDSLAB_H */
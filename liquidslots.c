@@ -0,0 +1,186 @@
+/**
+ * LiquidMem: densely packed slot maps.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidslots.c
+ *
+ * See README.md for quick-start info and liquidslots.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "liquidmem.h"
+#include "liquidslots.h"
+
+#define NO_SLOT UINT32_MAX
+
+static uint64_t makeHandle(uint32_t slot, uint32_t generation){
+	return (uint64_t)generation << 32 | slot;
+}
+
+/* The slot of a handle, if the handle is still valid. */
+static memslot_s * handleSlot(memslots_s * sm, uint64_t handle){
+	uint32_t slot = (uint32_t)handle;
+	
+	if(slot >= sm->slotCount ||
+			sm->slots[slot].generation != (uint32_t)(handle >> 32)){
+		return NULL;
+	}
+	
+	return sm->slots + slot;
+}
+
+/* Double the room for items and slots. */
+static memslots_s * grow(memslots_s * sm){
+	size_t size = sm->size ? sm->size * 2 : 16;
+	if(size > NO_SLOT){
+		return NULL;
+	}
+	
+	char * data = realloc(sm->data, size * sm->itemSize);
+	if(!data){
+		return NULL;
+	}
+	sm->data = data;
+	
+	uint32_t * owners = realloc(sm->owners, size * sizeof *owners);
+	if(!owners){
+		return NULL;
+	}
+	sm->owners = owners;
+	
+	// there are never more slots than room for items
+	memslot_s * slots = realloc(sm->slots, size * sizeof *slots);
+	if(!slots){
+		return NULL;
+	}
+	sm->slots = slots;
+	sm->size = size;
+	
+	return sm;
+}
+
+memslots_s * memslots_init(memslots_s * sm, size_t itemSize){
+	sm->length = 0;
+	sm->size = 0;
+	sm->itemSize = itemSize;
+	sm->data = NULL;
+	sm->owners = NULL;
+	sm->slotCount = 0;
+	sm->slots = NULL;
+	sm->freeSlot = NO_SLOT;
+	
+	return sm;
+}
+
+memslots_s * memslots_make(size_t itemSize){
+	memslots_s * ret = malloc(sizeof *ret);
+	if(!ret){
+		return NULL;
+	}
+	
+	return memslots_init(ret, itemSize);
+}
+
+memslots_s * memslots_reset(memslots_s * sm){
+	// free the slots of all items, so their handles go stale
+	while(sm->length){
+		memslots_release(sm, makeHandle(sm->owners[sm->length - 1],
+				sm->slots[sm->owners[sm->length - 1]].generation));
+	}
+	
+	return sm;
+}
+
+memslots_s * memslots_clear(memslots_s * sm){
+	free(sm->data);
+	free(sm->owners);
+	free(sm->slots);
+	
+	return memslots_init(sm, sm->itemSize);
+}
+
+void memslots_free(memslots_s * sm){
+	memslots_clear(sm);
+	free(sm);
+}
+
+void * memslots_alloc(memslots_s * sm, uint64_t * handle){
+	if(sm->length == sm->size && !grow(sm)){
+		return NULL;
+	}
+	
+	uint32_t slot = sm->freeSlot;
+	if(slot != NO_SLOT){
+		sm->freeSlot = sm->slots[slot].index;
+	}else{
+		slot = (uint32_t)sm->slotCount++;
+		sm->slots[slot].generation = 1;
+	}
+	
+	size_t index = sm->length++;
+	sm->slots[slot].index = (uint32_t)index;
+	sm->owners[index] = slot;
+	*handle = makeHandle(slot, sm->slots[slot].generation);
+	
+	return sm->data + index * sm->itemSize;
+}
+
+memslots_s * memslots_release(memslots_s * sm, uint64_t handle){
+	memslot_s * slot = handleSlot(sm, handle);
+	if(!slot){
+		return NULL;
+	}
+	
+	// move the last item into the hole
+	size_t index = slot->index;
+	size_t last = --sm->length;
+	if(index != last){
+		memcpy(sm->data + index * sm->itemSize, sm->data + last * sm->itemSize,
+				sm->itemSize);
+		sm->owners[index] = sm->owners[last];
+		sm->slots[sm->owners[index]].index = (uint32_t)index;
+	}
+	
+	if(!++slot->generation){
+		slot->generation = 1;
+	}
+	slot->index = sm->freeSlot;
+	sm->freeSlot = (uint32_t)(slot - sm->slots);
+	
+	return sm;
+}
+
+void * memslots_get(memslots_s * sm, uint64_t handle){
+	memslot_s * slot = handleSlot(sm, handle);
+	if(!slot){
+		return NULL;
+	}
+	
+	return sm->data + slot->index * sm->itemSize;
+}
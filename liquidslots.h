@@ -0,0 +1,151 @@
+/**
+ * LiquidMem: densely packed slot maps.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidslots.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDSLOTS_H
+#define LIQUIDSLOTS_H
+
+#include <stdint.h> /* uint32_t, uint64_t */
+
+#include "liquidmem.h"
+
+/** A handle that never refers to an item. */
+#define MEMSLOTS_NONE ((uint64_t)0)
+
+/**
+ * A slot in the indirection table of a slot map.
+ */
+typedef struct memslot{
+	/** The index of the item in the dense array, or the next free slot. */
+	uint32_t index;
+	/** Counts up each time the slot's item is released, never 0. */
+	uint32_t generation;
+} memslot_s;
+
+/**
+ * A slot map holds items of fixed size densely packed in one array: releasing
+ * an item moves the last item into its place. Items are referred to by handles
+ * that stay valid when items move: they hold a slot in the indirection table,
+ * and the generation of that slot, so that handles of released items are
+ * detected. Walking over all items is a walk over the array.
+ */
+typedef struct memslots{
+	/** The number of items. */
+	size_t length;
+	/** The number of items there is room for. */
+	size_t size;
+	/** The size of the items. */
+	size_t itemSize;
+	/** The items. */
+	char * data;
+	/** The slot of each item. */
+	uint32_t * owners;
+	
+	/** The number of slots. */
+	size_t slotCount;
+	/** The slots. */
+	memslot_s * slots;
+	/** The first free slot, UINT32_MAX if none. */
+	uint32_t freeSlot;
+} memslots_s;
+
+/**
+ * Get the items of a slot map as an array of the given type.
+ *
+ * @param sm The slot map.
+ * @param type The type of the items.
+ * @return The array, of sm->length items.
+ */
+#define memslots_data(sm, type) ((type *)(sm)->data)
+
+/**
+ * Initialize a slot map.
+ *
+ * @param sm The slot map to initialize.
+ * @param itemSize The size of the items.
+ * @return sm.
+ */
+memslots_s * memslots_init(memslots_s * sm, size_t itemSize);
+/**
+ * Malloc and initialize a slot map.
+ *
+ * @param itemSize The size of the items.
+ * @return An initialized slot map, or NULL on error.
+ */
+memslots_s * memslots_make(size_t itemSize);
+/**
+ * Reset a slot map: release all items. Handles to them become invalid.
+ *
+ * @param sm The slot map to reset.
+ * @return sm.
+ */
+memslots_s * memslots_reset(memslots_s * sm);
+/**
+ * De-initialize a slot map: release all items and invalidate the storage.
+ *
+ * @param sm The slot map to clear.
+ * @return sm.
+ */
+memslots_s * memslots_clear(memslots_s * sm);
+/**
+ * Clear and free a slot map that was made with memslots_make.
+ *
+ * @param sm The slot map to free, must have been obtained with memslots_make.
+ */
+void memslots_free(memslots_s * sm);
+/**
+ * Allocate an item at the end of the slot map.
+ *
+ * @param sm The slot map.
+ * @param handle Set to the handle of the item.
+ * @return A pointer to the item, valid until the next alloc or release, or 
+ *         NULL on error.
+ */
+void * memslots_alloc(memslots_s * sm, uint64_t * handle);
+/**
+ * Release an item: the last item is moved into its place.
+ *
+ * @param sm The slot map.
+ * @param handle The handle of the item.
+ * @return sm, or NULL if the handle is not valid.
+ */
+memslots_s * memslots_release(memslots_s * sm, uint64_t handle);
+/**
+ * Get an item by its handle.
+ *
+ * @param sm The slot map.
+ * @param handle The handle of the item.
+ * @return A pointer to the item, valid until the next alloc or release, or
+ *         NULL if the handle is not valid.
+ */
+void * memslots_get(memslots_s * sm, uint64_t handle);
+
+#endif /* LIQUIDSLOTS_H */
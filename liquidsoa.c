@@ -0,0 +1,124 @@
+/**
+ * LiquidMem: pools split into an array per field.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidsoa.c
+ *
+ * See README.md for quick-start info and liquidsoa.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquidmem.h"
+#include "liquidsoa.h"
+
+memsoa_s * memsoa_init(memsoa_s * soa, size_t bathSize, size_t fieldCount,
+		const size_t * fieldSizes){
+	soa->fieldCount = fieldCount;
+	soa->fieldSizes = malloc(fieldCount * sizeof *soa->fieldSizes);
+	soa->fieldOffsets = malloc(fieldCount * sizeof *soa->fieldOffsets);
+	if(!soa->fieldSizes || !soa->fieldOffsets){
+		return NULL;
+	}
+	
+	size_t itemSize = 0;
+	for(size_t i = 0; i < fieldCount; i++){
+		soa->fieldSizes[i] = fieldSizes[i];
+		soa->fieldOffsets[i] = itemSize;
+		itemSize += fieldSizes[i];
+	}
+	
+	bathSize = (bathSize + MEMSOA_ALIGN - 1) / MEMSOA_ALIGN * MEMSOA_ALIGN;
+	if(!mempool_init(&soa->pool, bathSize, itemSize)){
+		return NULL;
+	}
+	
+	return soa;
+}
+
+memsoa_s * memsoa_make(size_t bathSize, size_t fieldCount,
+		const size_t * fieldSizes){
+	memsoa_s * ret = malloc(sizeof *ret);
+	if(!ret){
+		return NULL;
+	}
+	
+	return memsoa_init(ret, bathSize, fieldCount, fieldSizes);
+}
+
+memsoa_s * memsoa_reset(memsoa_s * soa){
+	mempool_recycle(&soa->pool);
+	
+	return soa;
+}
+
+memsoa_s * memsoa_clear(memsoa_s * soa){
+	mempool_clear(&soa->pool);
+	free(soa->fieldSizes);
+	free(soa->fieldOffsets);
+	
+	soa->fieldSizes = NULL;
+	soa->fieldOffsets = NULL;
+	soa->fieldCount = 0;
+	
+	return soa;
+}
+
+void memsoa_free(memsoa_s * soa){
+	memsoa_clear(soa);
+	free(soa);
+}
+
+size_t memsoa_alloc(memsoa_s * soa){
+	size_t index;
+	
+	if(!mempool_alloc_index(&soa->pool, &index)){
+		return MEMPOOL_NONE;
+	}
+	
+	return index;
+}
+
+memsoa_s * memsoa_release(memsoa_s * soa, size_t index){
+	if(!mempool_release_index(&soa->pool, index)){
+		return NULL;
+	}
+	
+	return soa;
+}
+
+void * memsoa_array(memsoa_s * soa, size_t bath, size_t field){
+	return soa->pool.baths[bath].data + 
+			soa->pool.bathSize * soa->fieldOffsets[field];
+}
+
+void * memsoa_field(memsoa_s * soa, size_t index, size_t field){
+	size_t bathSize = soa->pool.bathSize;
+	char * array = memsoa_array(soa, index / bathSize, field);
+	
+	return array + index % bathSize * soa->fieldSizes[field];
+}
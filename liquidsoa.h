@@ -0,0 +1,151 @@
+/**
+ * LiquidMem: pools split into an array per field.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidsoa.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDSOA_H
+#define LIQUIDSOA_H
+
+#include "liquidmem.h"
+#include "bitarray.h"
+
+/** The number of items per bath of a split pool is a multiple of this. */
+#define MEMSOA_ALIGN 16
+
+/**
+ * A split pool holds items of fixed layout, but stores each of their fields in
+ * an array of its own: each bath holds the array of the first field, followed 
+ * by that of the second, and so on. Items are referred to by their index in
+ * the pool, and a sweep over one field of a bath touches only that field.
+ *
+ * The pool underneath hands out the indices and keeps track of the slots in
+ * use; its item pointers (from mempool_alloc or mempool_at) are meaningless.
+ */
+typedef struct memsoa{
+	/** The number of fields. */
+	size_t fieldCount;
+	/** The sizes of the fields. */
+	size_t * fieldSizes;
+	/** The offsets of the fields' arrays in a bath, per item in the bath. */
+	size_t * fieldOffsets;
+	
+	/** The pool of items, its item size is the sum of the field sizes. */
+	mempool_s pool;
+} memsoa_s;
+
+/**
+ * Test whether an item is in use.
+ *
+ * @param soa The split pool.
+ * @param index The index of the item.
+ * @return 0 if the item is not in use, >0 if it is.
+ */
+#define memsoa_used(soa, index)                                                \
+		bitArray_test((soa)->pool.baths[(index) / (soa)->pool.bathSize].useMap,\
+				(index) % (soa)->pool.bathSize)
+
+/**
+ * Initialize a split pool.
+ *
+ * @param soa The split pool to initialize.
+ * @param bathSize The number of items per bath, rounded up to a multiple of 
+ *                 MEMSOA_ALIGN so each field's array is aligned.
+ * @param fieldCount The number of fields.
+ * @param fieldSizes The size of each field.
+ * @return soa if successful, NULL on error.
+ */
+memsoa_s * memsoa_init(memsoa_s * soa, size_t bathSize, size_t fieldCount,
+		const size_t * fieldSizes);
+/**
+ * Malloc and initialize a split pool.
+ *
+ * @param bathSize The number of items per bath, see memsoa_init.
+ * @param fieldCount The number of fields.
+ * @param fieldSizes The size of each field.
+ * @return An initialized split pool, or NULL on error.
+ */
+memsoa_s * memsoa_make(size_t bathSize, size_t fieldCount,
+		const size_t * fieldSizes);
+/**
+ * Reset a split pool: release all items, but keep all baths.
+ *
+ * @param soa The split pool to reset.
+ * @return soa.
+ */
+memsoa_s * memsoa_reset(memsoa_s * soa);
+/**
+ * De-initialize a split pool: release all items and invalidate the storage.
+ *
+ * @param soa The split pool to clear.
+ * @return soa.
+ */
+memsoa_s * memsoa_clear(memsoa_s * soa);
+/**
+ * Clear and free a split pool that was made with memsoa_make.
+ *
+ * @param soa The split pool to free, must have been obtained with memsoa_make.
+ */
+void memsoa_free(memsoa_s * soa);
+/**
+ * Allocate an item from the split pool.
+ *
+ * @param soa The split pool.
+ * @return The index of the item, or MEMPOOL_NONE on error.
+ */
+size_t memsoa_alloc(memsoa_s * soa);
+/**
+ * Release an item back to the split pool.
+ *
+ * @param soa The split pool.
+ * @param index The index of the item.
+ * @return soa, or NULL if the item was not allocated.
+ */
+memsoa_s * memsoa_release(memsoa_s * soa, size_t index);
+/**
+ * Get a field of an item.
+ *
+ * @param soa The split pool.
+ * @param index The index of the item.
+ * @param field The index of the field.
+ * @return A pointer to the field of the item.
+ */
+void * memsoa_field(memsoa_s * soa, size_t index, size_t field);
+/**
+ * Get the array of a field in a bath. It holds the field for each of the 
+ * bath's slots, whether in use or not: the useMap of the bath tells which.
+ *
+ * @param soa The split pool.
+ * @param bath The index of the bath, less than the length of the pool.
+ * @param field The index of the field.
+ * @return The array of the field.
+ */
+void * memsoa_array(memsoa_s * soa, size_t bath, size_t field);
+
+#endif /* LIQUIDSOA_H */
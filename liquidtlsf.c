@@ -0,0 +1,378 @@
+/**
+ * LiquidMem: two-level segregated fit allocators.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidtlsf.c
+ *
+ * See README.md for quick-start info and liquidtlsf.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <limits.h>
+
+#include "liquidmem.h"
+#include "liquidtlsf.h"
+
+#define FREE_BIT      ((size_t)1)
+#define PREV_FREE_BIT ((size_t)2)
+
+/* The header before each item. */
+#define HEADER offsetof(memtlsfblock_s, nextFree)
+/* The smallest item, big enough for the links of a free block. */
+#define MIN_SIZE (sizeof(memtlsfblock_s) - HEADER)
+/* Sizes below this are all in first-level class 0, split linearly. */
+#define SMALL (MEMTLSF_SL * MEMTLSF_ALIGN)
+
+/* Index of the highest set bit in a non-zero size. */
+static unsigned int highestBit(size_t size){
+#ifdef __GNUC__
+	return sizeof(unsigned long long) * CHAR_BIT - 1 - 
+			__builtin_clzll((unsigned long long)size);
+#else /* !__GNUC__ */
+	unsigned int i = 0;
+	while(size >>= 1){
+		i++;
+	}
+	
+	return i;
+#endif /* __GNUC__ */
+}
+
+/* Index of the lowest set bit in a non-zero size. */
+static unsigned int lowestBit(size_t size){
+#ifdef __GNUC__
+	return __builtin_ctzll((unsigned long long)size);
+#else /* !__GNUC__ */
+	unsigned int i = 0;
+	while(!(size & 1)){
+		size >>= 1;
+		i++;
+	}
+	
+	return i;
+#endif /* __GNUC__ */
+}
+
+/*
+ * Blocks
+ */
+
+static size_t blockSize(memtlsfblock_s * block){
+	return block->size & ~(FREE_BIT | PREV_FREE_BIT);
+}
+
+static void * blockItem(memtlsfblock_s * block){
+	return (char *)block + HEADER;
+}
+
+static memtlsfblock_s * itemBlock(void * ptr){
+	return (memtlsfblock_s *)((char *)ptr - HEADER);
+}
+
+static memtlsfblock_s * nextPhys(memtlsfblock_s * block){
+	return (memtlsfblock_s *)((char *)blockItem(block) + blockSize(block));
+}
+
+/* Set whether the block is free, in its own header and in the next. */
+static void markFree(memtlsfblock_s * block, int isFree){
+	memtlsfblock_s * next = nextPhys(block);
+	
+	if(isFree){
+		block->size |= FREE_BIT;
+		next->size |= PREV_FREE_BIT;
+	}else{
+		block->size &= ~FREE_BIT;
+		next->size &= ~PREV_FREE_BIT;
+	}
+}
+
+/*
+ * Free lists
+ */
+
+/* The classes of a size: fl by power of 2, sl by linear steps within it. */
+static void mapping(size_t size, unsigned int * fl, unsigned int * sl){
+	if(size < SMALL){
+		*fl = 0;
+		*sl = (unsigned int)(size / MEMTLSF_ALIGN);
+		return;
+	}
+	
+	unsigned int bit = highestBit(size);
+	*fl = bit - highestBit(SMALL) + 1;
+	*sl = (unsigned int)(size >> (bit - highestBit(MEMTLSF_SL))) ^ MEMTLSF_SL;
+}
+
+static void insertFree(memtlsf_s * tlsf, memtlsfblock_s * block){
+	unsigned int fl, sl;
+	mapping(blockSize(block), &fl, &sl);
+	
+	block->prevFree = NULL;
+	block->nextFree = tlsf->free[fl][sl];
+	if(block->nextFree){
+		block->nextFree->prevFree = block;
+	}
+	tlsf->free[fl][sl] = block;
+	
+	tlsf->flMap |= (size_t)1 << fl;
+	tlsf->slMaps[fl] |= 1u << sl;
+}
+
+static void removeFree(memtlsf_s * tlsf, memtlsfblock_s * block){
+	unsigned int fl, sl;
+	mapping(blockSize(block), &fl, &sl);
+	
+	if(block->prevFree){
+		block->prevFree->nextFree = block->nextFree;
+	}else{
+		tlsf->free[fl][sl] = block->nextFree;
+	}
+	if(block->nextFree){
+		block->nextFree->prevFree = block->prevFree;
+	}
+	
+	if(!tlsf->free[fl][sl]){
+		tlsf->slMaps[fl] &= ~(1u << sl);
+		if(!tlsf->slMaps[fl]){
+			tlsf->flMap &= ~((size_t)1 << fl);
+		}
+	}
+}
+
+/* Round a size up to the next class boundary, where every block of the class
+ * is large enough. Returns 0 on overflow. */
+static size_t roundUp(size_t size){
+	if(size < SMALL){
+		return size;
+	}
+	
+	size_t step = ((size_t)1 << (highestBit(size) - highestBit(MEMTLSF_SL))) - 1;
+	if(size + step < size){
+		return 0;
+	}
+	
+	return (size + step) & ~step;
+}
+
+/* Find a free block of at least size bytes, from a class whose blocks are all
+ * large enough. */
+static memtlsfblock_s * findFree(memtlsf_s * tlsf, size_t size){
+	size = roundUp(size);
+	if(!size){
+		return NULL;
+	}
+	
+	unsigned int fl, sl;
+	mapping(size, &fl, &sl);
+	if(fl >= MEMTLSF_FL){
+		return NULL;
+	}
+	
+	unsigned int slMap = tlsf->slMaps[fl] & (~0u << sl);
+	if(!slMap){
+		size_t flMap = fl + 1 < MEMTLSF_FL ? 
+				tlsf->flMap & (~(size_t)0 << (fl + 1)) : 0;
+		if(!flMap){
+			return NULL;
+		}
+		
+		fl = lowestBit(flMap);
+		slMap = tlsf->slMaps[fl];
+	}
+	
+	return tlsf->free[fl][lowestBit(slMap)];
+}
+
+/*
+ * Regions
+ */
+
+/* Add a region with room for an item of at least size bytes, that findFree
+ * will find: its block must be at least size rounded up to its class. */
+static memtlsf_s * addRegion(memtlsf_s * tlsf, size_t size){
+	size_t total = tlsf->regionSize;
+	size_t need = roundUp(size);
+	if(size && !need){
+		return NULL;
+	}
+	if(need > total - 2 * HEADER){
+		total = need + 2 * HEADER;
+		if(total < need){
+			return NULL;
+		}
+	}
+	
+	unsigned int fl, sl;
+	mapping(total, &fl, &sl);
+	if(fl >= MEMTLSF_FL){
+		return NULL;
+	}
+	
+	char * region = memriver_alloc_aligned(&tlsf->river, total, MEMTLSF_ALIGN);
+	if(!region){
+		return NULL;
+	}
+	
+	// one free block, followed by a used block of size 0 that ends the region
+	memtlsfblock_s * block = (memtlsfblock_s *)region;
+	block->prevPhys = NULL;
+	block->size = total - 2 * HEADER;
+	
+	memtlsfblock_s * end = nextPhys(block);
+	end->prevPhys = block;
+	end->size = 0;
+	
+	markFree(block, 1);
+	insertFree(tlsf, block);
+	
+	return tlsf;
+}
+
+/*
+ * Allocator functions
+ */
+
+memtlsf_s * memtlsf_init(memtlsf_s * tlsf, size_t regionSize){
+	// room for the end of the region and the smallest block, at least
+	regionSize &= ~(MEMTLSF_ALIGN - 1);
+	if(regionSize < 2 * HEADER + MIN_SIZE){
+		regionSize = 2 * HEADER + MIN_SIZE;
+	}
+	tlsf->regionSize = regionSize;
+	
+	if(!memriver_init(&tlsf->river, regionSize + MEMTLSF_ALIGN)){
+		return NULL;
+	}
+	
+	return memtlsf_reset(tlsf);
+}
+
+memtlsf_s * memtlsf_make(size_t regionSize){
+	memtlsf_s * ret = malloc(sizeof *ret);
+	
+	if(!ret){
+		return NULL;
+	}
+	
+	return memtlsf_init(ret, regionSize);
+}
+
+memtlsf_s * memtlsf_reset(memtlsf_s * tlsf){
+	tlsf->flMap = 0;
+	for(size_t fl = 0; fl < MEMTLSF_FL; fl++){
+		tlsf->slMaps[fl] = 0;
+		for(size_t sl = 0; sl < MEMTLSF_SL; sl++){
+			tlsf->free[fl][sl] = NULL;
+		}
+	}
+	
+	if(!memriver_reset(&tlsf->river)){
+		return NULL;
+	}
+	
+	return addRegion(tlsf, 0);
+}
+
+memtlsf_s * memtlsf_clear(memtlsf_s * tlsf){
+	memriver_clear(&tlsf->river);
+	
+	return tlsf;
+}
+
+void memtlsf_free(memtlsf_s * tlsf){
+	memtlsf_clear(tlsf);
+	free(tlsf);
+}
+
+void * memtlsf_alloc(memtlsf_s * tlsf, size_t size){
+	size_t need = (size + MEMTLSF_ALIGN - 1) & ~(MEMTLSF_ALIGN - 1);
+	if(need < size){
+		return NULL;
+	}
+	if(need < MIN_SIZE){
+		need = MIN_SIZE;
+	}
+	
+	memtlsfblock_s * block = findFree(tlsf, need);
+	if(!block){
+		if(!addRegion(tlsf, need) || !(block = findFree(tlsf, need))){
+			return NULL;
+		}
+	}
+	removeFree(tlsf, block);
+	
+	// split off the rest, if it makes a block of its own
+	size_t rest = blockSize(block) - need;
+	if(rest >= HEADER + MIN_SIZE){
+		block->size = need | (block->size & PREV_FREE_BIT);
+		
+		memtlsfblock_s * split = nextPhys(block);
+		split->prevPhys = block;
+		split->size = rest - HEADER;
+		nextPhys(split)->prevPhys = split;
+		
+		markFree(split, 1);
+		insertFree(tlsf, split);
+	}
+	
+	markFree(block, 0);
+	
+	return blockItem(block);
+}
+
+memtlsf_s * memtlsf_release(memtlsf_s * tlsf, void * ptr){
+	if(!ptr){
+		return tlsf;
+	}
+	
+	memtlsfblock_s * block = itemBlock(ptr);
+	
+	// merge with the next block, then with the previous, if they are free
+	memtlsfblock_s * next = nextPhys(block);
+	if(next->size & FREE_BIT){
+		removeFree(tlsf, next);
+		block->size += HEADER + blockSize(next);
+		nextPhys(block)->prevPhys = block;
+	}
+	
+	if(block->size & PREV_FREE_BIT){
+		memtlsfblock_s * prev = block->prevPhys;
+		removeFree(tlsf, prev);
+		prev->size += HEADER + blockSize(block);
+		block = prev;
+		nextPhys(block)->prevPhys = block;
+	}
+	
+	markFree(block, 1);
+	insertFree(tlsf, block);
+	
+	return tlsf;
+}
+
+size_t memtlsf_size(void * ptr){
+	return blockSize(itemBlock(ptr));
+}
@@ -0,0 +1,149 @@
+/**
+ * LiquidMem: two-level segregated fit allocators.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidtlsf.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDTLSF_H
+#define LIQUIDTLSF_H
+
+#include "liquidmem.h"
+
+/** The number of first-level classes: one per power of 2. */
+#define MEMTLSF_FL 32
+/** The number of second-level classes per first-level class. */
+#define MEMTLSF_SL 16
+/** The alignment of the blocks, and the granularity of their sizes. */
+#define MEMTLSF_ALIGN (2 * sizeof(void *))
+
+/**
+ * A block of a TLSF allocator. The header (prevPhys and size) precedes every
+ * block; the links to the other free blocks of its class are only there while
+ * the block is free, in what is otherwise the block's item.
+ */
+typedef struct memtlsfblock{
+	/** The block right before this one in its region. */
+	struct memtlsfblock * prevPhys;
+	/** The size of the block's item. The lowest bit is set while the block
+	 *  is free, the next while the block before it is free. */
+	size_t size;
+	
+	/** The next free block of the same class. */
+	struct memtlsfblock * nextFree;
+	/** The previous free block of the same class. */
+	struct memtlsfblock * prevFree;
+} memtlsfblock_s;
+
+/**
+ * A two-level segregated fit allocator hands out items of any size, from 
+ * regions taken from a river, and takes them back, in constant time. The free
+ * blocks are kept in lists by size: the first level splits sizes by powers of
+ * 2, the second splits each of those in MEMTLSF_SL linear steps, and bitmaps of
+ * both levels find a non-empty list big enough in a few bit operations. Freed
+ * blocks are merged with free neighbours right away.
+ *
+ * Only adding a region, when no free block is large enough, takes longer. 
+ * Sizing the regions to what is needed at most keeps that from happening.
+ */
+typedef struct memtlsf{
+	/** The first-level bitmap: which first-level classes have free blocks. */
+	size_t flMap;
+	/** The second-level bitmaps: which lists have free blocks. */
+	unsigned int slMaps[MEMTLSF_FL];
+	/** The lists of free blocks. */
+	memtlsfblock_s * free[MEMTLSF_FL][MEMTLSF_SL];
+	
+	/** The size of the regions. */
+	size_t regionSize;
+	/** The river the regions are taken from. */
+	memriver_s river;
+} memtlsf_s;
+
+/**
+ * Initialize an allocator, with 1 region.
+ *
+ * @param tlsf The allocator to initialize.
+ * @param regionSize The size of the regions. Items that don't fit in one, 
+ *                   rounded up to their class, get a region of their own.
+ * @return tlsf if successful, NULL on error.
+ */
+memtlsf_s * memtlsf_init(memtlsf_s * tlsf, size_t regionSize);
+/**
+ * Malloc and initialize an allocator.
+ *
+ * @param regionSize The size of the regions, see memtlsf_init.
+ * @return An initialized allocator, or NULL on error.
+ */
+memtlsf_s * memtlsf_make(size_t regionSize);
+/**
+ * Reset an allocator: release all items and go back to 1 region.
+ *
+ * @param tlsf The allocator to reset.
+ * @return tlsf, or NULL on error.
+ */
+memtlsf_s * memtlsf_reset(memtlsf_s * tlsf);
+/**
+ * De-initialize an allocator: release all items and the regions.
+ *
+ * @param tlsf The allocator to clear.
+ * @return tlsf.
+ */
+memtlsf_s * memtlsf_clear(memtlsf_s * tlsf);
+/**
+ * Clear and free an allocator that was made with memtlsf_make.
+ *
+ * @param tlsf The allocator to free, must have been obtained with memtlsf_make.
+ */
+void memtlsf_free(memtlsf_s * tlsf);
+/**
+ * Allocate an item, in constant time unless a region has to be added.
+ *
+ * @param tlsf The allocator.
+ * @param size The size of the item.
+ * @return The item, aligned to MEMTLSF_ALIGN, or NULL on error.
+ */
+void * memtlsf_alloc(memtlsf_s * tlsf, size_t size);
+/**
+ * Release an item, in constant time.
+ *
+ * @param tlsf The allocator.
+ * @param ptr The item, obtained via memtlsf_alloc on tlsf. May be NULL.
+ * @return tlsf.
+ */
+memtlsf_s * memtlsf_release(memtlsf_s * tlsf, void * ptr);
+/**
+ * Get the size of an item, which may be larger than the size it was allocated
+ * with.
+ *
+ * @param ptr The item, obtained via memtlsf_alloc.
+ * @return The size.
+ */
+size_t memtlsf_size(void * ptr);
+
+#endif /* LIQUIDTLSF_H */
@@ -0,0 +1,189 @@
+/**
+ * LiquidMem: growing vectors and strings in rivers.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidvec.c
+ *
+ * See README.md for quick-start info and liquidvec.h for doc-comments.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "liquidmem.h"
+#include "liquidvec.h"
+
+/*
+ * Vector functions
+ */
+
+memvec_s * memvec_init(memvec_s * vec, memriver_s * riv, size_t itemSize){
+	vec->length = 0;
+	vec->size = 0;
+	vec->itemSize = itemSize;
+	vec->data = NULL;
+	vec->river = riv;
+	
+	return vec;
+}
+
+memvec_s * memvec_reserve(memvec_s * vec, size_t n){
+	if(vec->size - vec->length >= n){
+		return vec;
+	}
+	
+	size_t need = vec->length + n;
+	size_t size = vec->size ? vec->size : 8;
+	while(size < need){
+		size *= 2;
+	}
+	
+	// when the array is on top of its creek this just moves the creek's end
+	char * data = memriver_realloc(vec->river, vec->data,
+			vec->size * vec->itemSize, size * vec->itemSize);
+	if(!data){
+		return NULL;
+	}
+	
+	vec->data = data;
+	vec->size = size;
+	
+	return vec;
+}
+
+void * memvec_push(memvec_s * vec){
+	if(!memvec_reserve(vec, 1)){
+		return NULL;
+	}
+	
+	return vec->data + vec->length++ * vec->itemSize;
+}
+
+memvec_s * memvec_append(memvec_s * vec, const void * src, size_t n){
+	if(!memvec_reserve(vec, n)){
+		return NULL;
+	}
+	
+	memcpy(vec->data + vec->length * vec->itemSize, src, n * vec->itemSize);
+	vec->length += n;
+	
+	return vec;
+}
+
+void * memvec_freeze(memvec_s * vec){
+	void * ret = NULL;
+	
+	if(vec->length){
+		// give back the room that wasn't used, if the array is on top of the
+		// last creek; anywhere else it is handed out as it is
+		memcreek_s * crk = vec->river->creeks + vec->river->length - 1;
+		size_t size = vec->size * vec->itemSize;
+		
+		ret = vec->data;
+		if(crk->length >= size && vec->data + size == crk->data + crk->length){
+			ret = memriver_realloc(vec->river, vec->data, size,
+					vec->length * vec->itemSize);
+		}
+	}
+	
+	memvec_init(vec, vec->river, vec->itemSize);
+	
+	return ret;
+}
+
+/*
+ * String builder functions
+ */
+
+memstr_s * memstr_init(memstr_s * str, memriver_s * riv){
+	return memvec_init(str, riv, 1);
+}
+
+memstr_s * memstr_append(memstr_s * str, const char * src, size_t n){
+	// keep room for the nul
+	if(!memvec_reserve(str, n + 1)){
+		return NULL;
+	}
+	
+	memcpy(str->data + str->length, src, n);
+	str->length += n;
+	str->data[str->length] = '\0';
+	
+	return str;
+}
+
+memstr_s * memstr_puts(memstr_s * str, const char * src){
+	return memstr_append(str, src, strlen(src));
+}
+
+memstr_s * memstr_vprintf(memstr_s * str, const char * fmt, va_list args){
+	if(!memvec_reserve(str, 1)){
+		return NULL;
+	}
+	
+	size_t room = str->size - str->length;
+	va_list copy;
+	
+	va_copy(copy, args);
+	int len = vsnprintf(str->data + str->length, room, fmt, copy);
+	va_end(copy);
+	
+	if(len < 0){
+		return NULL;
+	}
+	
+	if((size_t)len >= room){
+		if(!memvec_reserve(str, (size_t)len + 1)){
+			return NULL;
+		}
+		vsnprintf(str->data + str->length, (size_t)len + 1, fmt, args);
+	}
+	str->length += len;
+	
+	return str;
+}
+
+memstr_s * memstr_printf(memstr_s * str, const char * fmt, ...){
+	va_list args;
+	
+	va_start(args, fmt);
+	memstr_s * ret = memstr_vprintf(str, fmt, args);
+	va_end(args);
+	
+	return ret;
+}
+
+char * memstr_freeze(memstr_s * str){
+	// include the nul
+	if(!memvec_reserve(str, 1)){
+		return NULL;
+	}
+	str->data[str->length++] = '\0';
+	
+	return memvec_freeze(str);
+}
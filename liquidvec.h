@@ -0,0 +1,179 @@
+/**
+ * LiquidMem: growing vectors and strings in rivers.
+ * @author  Marco Gunnink <marco@kninnug.nl>
+ * @date    2026-10-16
+ * @version 1.0.0
+ * @file    liquidvec.h
+ *
+ * See README.md for quick-start info.
+ *
+ * License: MIT
+ *
+ * Copyright (c) 2016 Marco Gunnink
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages or other
+ * liability, whether in an action of contract, tort or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in
+ * the software.
+ */
+
+#ifndef LIQUIDVEC_H
+#define LIQUIDVEC_H
+
+#include <stdarg.h> /* va_list */
+
+#include "liquidmem.h"
+
+/**
+ * A vector holds a growing array of items of fixed size, allocated from a 
+ * river. As long as the array is the last item in its creek, it grows in place.
+ */
+typedef struct memvec{
+	/** The number of items. */
+	size_t length;
+	/** The number of items there is room for. */
+	size_t size;
+	/** The size of the items. */
+	size_t itemSize;
+	
+	/** The items. */
+	char * data;
+	/** The river to allocate from. */
+	memriver_s * river;
+} memvec_s;
+
+/**
+ * A string builder is a vector of chars, that is kept nul-terminated once
+ * anything has been appended to it.
+ */
+typedef memvec_s memstr_s;
+
+/**
+ * Get the items of a vector as an array of the given type.
+ *
+ * @param vec The vector.
+ * @param type The type of the items.
+ * @return The array.
+ */
+#define memvec_data(vec, type) ((type *)(vec)->data)
+
+/**
+ * Get an item of a vector as the given type.
+ *
+ * @param vec The vector.
+ * @param type The type of the items.
+ * @param i The index of the item.
+ * @return The item (an lvalue).
+ */
+#define memvec_at(vec, type, i) (memvec_data(vec, type)[i])
+
+/**
+ * Initialize a vector.
+ *
+ * @param vec The vector to initialize.
+ * @param riv The river to allocate from.
+ * @param itemSize The size of the items.
+ * @return vec.
+ */
+memvec_s * memvec_init(memvec_s * vec, memriver_s * riv, size_t itemSize);
+/**
+ * Make sure a vector has room for n more items.
+ *
+ * @param vec The vector.
+ * @param n The number of items to make room for.
+ * @return vec, or NULL on error.
+ */
+memvec_s * memvec_reserve(memvec_s * vec, size_t n);
+/**
+ * Add an item to the end of a vector.
+ *
+ * @param vec The vector.
+ * @return A pointer to the new (uninitialized) item, or NULL on error.
+ */
+void * memvec_push(memvec_s * vec);
+/**
+ * Copy n items to the end of a vector.
+ *
+ * @param vec The vector.
+ * @param src The items to copy.
+ * @param n The number of items.
+ * @return vec, or NULL on error.
+ */
+memvec_s * memvec_append(memvec_s * vec, const void * src, size_t n);
+/**
+ * Freeze a vector: hand out its array, shrunk to fit. The array remains valid
+ * as long as the river's items do. The vector is left empty and can be used to
+ * build a new array.
+ *
+ * @param vec The vector to freeze.
+ * @return The array, or NULL if the vector was empty.
+ */
+void * memvec_freeze(memvec_s * vec);
+
+/**
+ * Initialize a string builder.
+ *
+ * @param str The string builder to initialize.
+ * @param riv The river to allocate from.
+ * @return str.
+ */
+memstr_s * memstr_init(memstr_s * str, memriver_s * riv);
+/**
+ * Append n characters to a string builder.
+ *
+ * @param str The string builder.
+ * @param src The characters to append.
+ * @param n The number of characters.
+ * @return str, or NULL on error.
+ */
+memstr_s * memstr_append(memstr_s * str, const char * src, size_t n);
+/**
+ * Append a nul-terminated string to a string builder.
+ *
+ * @param str The string builder.
+ * @param src The string to append.
+ * @return str, or NULL on error.
+ */
+memstr_s * memstr_puts(memstr_s * str, const char * src);
+/**
+ * Append a formatted string to a string builder. It is formatted directly 
+ * into the builder's free space, and only formatted again if that didn't fit.
+ *
+ * @param str The string builder.
+ * @param fmt The printf-style format.
+ * @param args The arguments for the format.
+ * @return str, or NULL on error.
+ */
+memstr_s * memstr_vprintf(memstr_s * str, const char * fmt, va_list args);
+/**
+ * Append a formatted string to a string builder, see memstr_vprintf.
+ *
+ * @param str The string builder.
+ * @param fmt The printf-style format.
+ * @param ... The arguments for the format.
+ * @return str, or NULL on error.
+ */
+memstr_s * memstr_printf(memstr_s * str, const char * fmt, ...);
+/**
+ * Freeze a string builder: hand out its nul-terminated string, shrunk to fit.
+ * The builder is left empty and can be used to build a new string.
+ *
+ * @param str The string builder to freeze.
+ * @return The string, or NULL on error.
+ */
+char * memstr_freeze(memstr_s * str);
+
+#endif /* LIQUIDVEC_H */
@@ -3,8 +3,21 @@
 #include <time.h>
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "liquidmem.h"
+#include "liquidvec.h"
+#include "liquidmap.h"
+#include "liquidintern.h"
+#include "liquidlru.h"
+#include "liquidqueue.h"
+#include "liquidcolumn.h"
+#include "liquidsoa.h"
+#include "liquidslots.h"
+#include "liquidgen.h"
+#include "liquidring.h"
+#include "liquidslab.h"
+#include "liquidtlsf.h"
 
 /* Make a mempool and alloc n items. */
 static mempool_s * benchMempoolAlloc(size_t n, int * data[], unsigned int div){
@@ -130,6 +143,870 @@ static int checkData(size_t n, int * data[]){
 	return 1;
 }
 
+/* Check that oversized items go into lakes and not into the creeks. */
+static void checkMemriverLakes(void){
+	memriver_s * riv = memriver_make(64);
+	char * small = memriver_alloc(riv, 16);
+	char * big = memriver_alloc(riv, 1 << 20);
+	
+	assert(small && big && ((uintptr_t)big & 15) == 0);
+	memset(big, 42, 1 << 20);
+	assert(riv->length == 1 && riv->lakes && !riv->lakes->next);
+	assert(memriver_alloc(riv, 48) == small + 16);
+	
+	memriver_reset(riv);
+	assert(!riv->lakes);
+	memriver_free(riv);
+}
+
+/* Check growing the last item in place and moving it into a lake. */
+static void checkMemriverRealloc(void){
+	memriver_s * riv = memriver_make(64);
+	char * str = memriver_alloc(riv, 8);
+	
+	strcpy(str, "Hello");
+	assert(memriver_realloc(riv, str, 8, 32) == str);
+	assert(riv->creeks->length == 32);
+	
+	char * big = memriver_realloc(riv, str, 32, 256);
+	assert(big && big != str && !strcmp(big, "Hello"));
+	assert(riv->creeks->length == 0 && riv->lakes);
+	
+	str = memriver_realloc(riv, big, 256, 16);
+	assert(str && !strcmp(str, "Hello") && !riv->lakes);
+	
+	// shrinking an item that isn't on top leaves it where it is
+	assert(memriver_alloc(riv, 4) && riv->creeks->length == 20);
+	assert(memriver_realloc(riv, str, 16, 8) == str && riv->creeks->length == 20);
+	
+	memriver_free(riv);
+}
+
+/* Check rolling a river back to a mark, keeping and clearing its creeks. */
+static void checkMemriverRollback(void){
+	memriver_s * riv = memriver_make(64);
+	char * first = memriver_alloc(riv, 16);
+	memmark_s mark = memriver_mark(riv);
+	
+	for(int i = 0; i < 10; i++){
+		assert(memriver_alloc(riv, 40));
+	}
+	assert(memriver_alloc(riv, 1024) && riv->lakes);
+	
+	assert(memriver_rollback(riv, mark, 1));
+	assert(riv->length == 1 && riv->capacity > 1 && !riv->lakes);
+	assert(memriver_alloc(riv, 16) == first + 16);
+	assert(memriver_alloc(riv, 40) && riv->length == 2);
+	
+	assert(memriver_rollback(riv, mark, 0));
+	assert(riv->length == 1 && riv->capacity == 1);
+	assert(riv->creeks->length == 16);
+	
+	memriver_free(riv);
+}
+
+/* Check that recycling keeps all baths and creeks, or coalesces the creeks. */
+static void checkRecycle(void){
+	mempool_s * pool = mempool_make(4, sizeof(int));
+	for(int i = 0; i < 10; i++){
+		assert(mempool_alloc(pool));
+	}
+	assert(pool->length == 3 && pool->capacity == 3);
+	
+	mempool_recycle(pool);
+	assert(pool->length == 1 && pool->capacity == 3);
+	for(int i = 0; i < 10; i++){
+		assert(mempool_alloc(pool));
+	}
+	assert(pool->length == 3 && pool->capacity == 3);
+	mempool_free(pool);
+	
+	memriver_s * riv = memriver_make(64);
+	for(int i = 0; i < 10; i++){
+		assert(memriver_alloc(riv, 40));
+	}
+	assert(riv->length == 10);
+	
+	memriver_recycle(riv, 0);
+	assert(riv->length == 1 && riv->capacity == 10);
+	
+	memriver_recycle(riv, 1);
+	assert(riv->capacity == 1 && riv->creeks->size == 400);
+	for(int i = 0; i < 10; i++){
+		assert(memriver_alloc(riv, 40));
+	}
+	assert(riv->length == 1);
+	memriver_free(riv);
+}
+
+/* Check that adapting creeks grow geometrically and fit the peak on reset. */
+static void checkMemriverAdapt(void){
+	memriver_s * riv = memriver_adapt(memriver_make(64), 1024);
+	size_t sizes[] = {64, 128, 256, 512, 1024, 1024};
+	
+	for(int i = 0; i < 72; i++){
+		assert(memriver_alloc(riv, 40));
+	}
+	assert(riv->length == 6 && !riv->lakes);
+	for(int i = 0; i < 6; i++){
+		assert(riv->creeks[i].size == sizes[i]);
+	}
+	assert(memriver_alloc(riv, 512) && !riv->lakes);
+	
+	memriver_reset(riv);
+	assert(riv->peak == 72 * 40 + 512 && riv->creeks->size == 1024);
+	memriver_free(riv);
+}
+
+/* Check the string helpers, and printf both in and past the last creek. */
+static void checkMemriverStrings(void){
+	memriver_s * riv = memriver_make(32);
+	
+	char * str = memriver_strdup(riv, "Hello");
+	assert(!strcmp(str, "Hello") && riv->creeks->length == 6);
+	assert(!strcmp(memriver_strndup(riv, "world!", 5), "world"));
+	assert(!memcmp(memriver_memdup(riv, "abc", 3), "abc", 3));
+	
+	str = memriver_printf(riv, "%d-%s", 42, "x");
+	assert(!strcmp(str, "42-x") && riv->creeks->length == 20);
+	str = memriver_printf(riv, "%s, %s!", "Hello", "world");
+	assert(!strcmp(str, "Hello, world!") && riv->length == 2);
+	str = memriver_printf(riv, "%064d", 0);
+	assert(strlen(str) == 64 && riv->lakes);
+	
+	memriver_free(riv);
+}
+
+/* Check that vectors and strings grow in place and freeze without copying. */
+static void checkMemvec(void){
+	memriver_s * riv = memriver_make(1024);
+	memvec_s vec;
+	memstr_s str;
+	
+	memvec_init(&vec, riv, sizeof(int));
+	for(int i = 0; i < 100; i++){
+		*(int *)memvec_push(&vec) = i;
+	}
+	int * ints = memvec_data(&vec, int);
+	assert(vec.length == 100 && memvec_at(&vec, int, 99) == 99);
+	assert(memvec_freeze(&vec) == ints && riv->length == 1);
+	assert(riv->creeks->length == 100 * sizeof(int));
+	
+	memstr_init(&str, riv);
+	memstr_puts(&str, "Hello");
+	memstr_printf(&str, ", %s! %d", "world", 42);
+	char * hello = memstr_freeze(&str);
+	assert(!strcmp(hello, "Hello, world! 42") && hello == (char *)(ints + 100));
+	assert(riv->creeks->length == 100 * sizeof(int) + 17);
+	
+	// an array that isn't on top anymore is frozen where it is
+	memvec_init(&vec, riv, 1);
+	memvec_append(&vec, "0123456789", 10);
+	char * bytes = memvec_data(&vec, char);
+	size_t used = riv->creeks->length;
+	assert(memriver_alloc(riv, 4));
+	assert(memvec_freeze(&vec) == bytes && riv->creeks->length == used + 4);
+	
+	memriver_free(riv);
+}
+
+/* Check map insertion, lookup and removal, and that removed entries are
+ * re-used. */
+static void checkMemmap(void){
+	memmap_s * map = memmap_make(1024, sizeof(size_t), sizeof(int));
+	size_t n = 10000;
+	
+	for(size_t i = 0; i < n; i++){
+		*(int *)memmap_put(map, &i) = i;
+	}
+	assert(map->length == n && map->pool.length == 10);
+	for(size_t i = 0; i < n; i += 2){
+		assert(memmap_remove(map, &i));
+	}
+	assert(map->length == n / 2 && !memmap_remove(map, &(size_t){0}));
+	
+	for(size_t i = 0; i < n; i++){
+		int * val = memmap_get(map, &i);
+		assert(i % 2 ? val && *val == i : !val);
+	}
+	for(size_t i = n; i < n + n / 2; i++){
+		*(int *)memmap_put(map, &i) = i;
+	}
+	assert(map->length == n && map->pool.length == 10);
+	
+	memmap_free(map);
+}
+
+/* Check that a map keeps its entries through puts and removes mixed at 
+ * random, which re-use the slots of removed entries. */
+static void checkMemmapChurn(void){
+	memmap_s * map = memmap_make(64, sizeof(size_t), sizeof(size_t));
+	int present[512] = {0};
+	
+	for(int round = 0; round < 20000; round++){
+		size_t key = rand() % 512;
+		size_t * val = memmap_get(map, &key);
+		assert(present[key] ? val && *val == key : !val);
+		
+		if(present[key]){
+			assert(memmap_remove(map, &key));
+		}else{
+			*(size_t *)memmap_put(map, &key) = key;
+		}
+		present[key] = !present[key];
+	}
+	
+	memmap_free(map);
+}
+
+/* Check that equal strings are interned once, with stable IDs. */
+static void checkMemintern(void){
+	memintern_s * in = memintern_make(256);
+	char buf[16];
+	
+	const char * foo = memintern_str(in, "foo");
+	strcpy(buf, "foo");
+	assert(memintern_str(in, buf) == foo && in->length == 1);
+	assert(memintern_add(in, "foobar", 3) == 0);
+	
+	for(int i = 0; i < 1000; i++){
+		sprintf(buf, "key%d", i);
+		assert(memintern_add(in, buf, strlen(buf)) == i + 1);
+	}
+	assert(memintern_find(in, "key500", 6) == 501);
+	assert(!strcmp(memintern_at(in, 501)->str, "key500"));
+	assert(memintern_find(in, "key1000", 7) == MEMINTERN_NONE);
+	assert(memintern_str(in, "foo") == foo);
+	
+	memintern_free(in);
+}
+
+/* Check that a cache evicts the least recently used entry in its place. */
+static void checkMemlru(void){
+	memlru_s * lru = memlru_make(4, sizeof(size_t), sizeof(int));
+	
+	for(size_t i = 0; i < 4; i++){
+		*(int *)memlru_put(lru, &i) = i;
+	}
+	assert(memlru_get(lru, &(size_t){0}));
+	assert(*(size_t *)memlru_oldest(lru) == 1);
+	
+	int * val = memlru_peek(lru, &(size_t){1});
+	*(int *)memlru_put(lru, &(size_t){4}) = 4;
+	assert(memlru_put(lru, &(size_t){4}) == val && *val == 4);
+	assert(!memlru_peek(lru, &(size_t){1}) && memlru_peek(lru, &(size_t){0}));
+	assert(lru->map.length == 4 && lru->map.pool.length == 1);
+	
+	assert(memlru_remove(lru, &(size_t){2}));
+	assert(*(size_t *)memlru_oldest(lru) == 3);
+	
+	memlru_free(lru);
+}
+
+/* Check that a cache with small keys keeps its recency list intact over many
+ * evictions. */
+static void checkMemlruChurn(void){
+	memlru_s * lru = memlru_make(4, sizeof(uint32_t), sizeof(uint32_t));
+	
+	for(int round = 0; round < 100000; round++){
+		uint32_t key = rand() % 8;
+		uint32_t * val = rand() % 2 ? memlru_get(lru, &key) : NULL;
+		if(val){
+			assert(*val == key);
+		}else{
+			*(uint32_t *)memlru_put(lru, &key) = key;
+		}
+	}
+	
+	size_t length = 0;
+	for(memlrunode_s * node = lru->list.next; node != &lru->list; 
+			node = node->next){
+		assert(node->next->prev == node && ++length <= 4);
+		assert(((uintptr_t)node & (sizeof(void *) - 1)) == 0);
+	}
+	assert(length == 4 && lru->map.length == 4);
+	assert(*(uint32_t *)(lru->list.prev + 1) == 
+			*(const uint32_t *)memlru_oldest(lru));
+	
+	memlru_free(lru);
+}
+
+/* Check that a queue keeps its items in order, over several laps. */
+static void checkMemqueue(void){
+	memqueue_s * q = memqueue_make(6, sizeof(int));
+	int item = -1;
+	
+	assert(q->size == 8 && !memqueue_pop(q, &item));
+	for(int i = 0; i < 8; i++){
+		assert(memqueue_push(q, &i));
+	}
+	assert(!memqueue_push(q, &item));
+	
+	for(int i = 0; i < 100; i++){
+		assert(memqueue_pop(q, &item) && item == i);
+		int next = i + 8;
+		assert(memqueue_push(q, &next));
+	}
+	memqueue_free(q);
+	
+	// the smallest queue still tells full from empty
+	q = memqueue_make(1, sizeof(int));
+	assert(q->size == 2 && memqueue_push(q, &item) && memqueue_push(q, &item));
+	assert(!memqueue_push(q, &item));
+	assert(memqueue_pop(q, &item) && memqueue_pop(q, &item));
+	assert(!memqueue_pop(q, &item));
+	memqueue_free(q);
+}
+
+/* Check that columns sharing a river fill aligned chunks, and that strings
+ * can be kept as offsets and bytes. */
+static void checkMemcolumn(void){
+	memriver_s * riv = memriver_make(4096);
+	memcolumn_s longs, doubles, ends, bytes;
+	size_t n = 10000, total = 0;
+	
+	memcolumn_init(&longs, riv, sizeof(long long));
+	memcolumn_init(&doubles, riv, sizeof(double));
+	for(size_t i = 0; i < n; i++){
+		*(long long *)memcolumn_push(&longs) = i;
+		double d = i / 2.0;
+		memcolumn_append(&doubles, &d, 1);
+	}
+	assert(longs.length == n && memcolumn_get(&doubles, double, 999) == 499.5);
+	
+	for(size_t c = 0, len; c < longs.chunkCount; c++){
+		long long * span = memcolumn_span(&longs, c, &len);
+		assert((uintptr_t)span % MEMCOLUMN_ALIGN == 0);
+		for(size_t i = 0; i < len; i++){
+			total += span[i];
+		}
+	}
+	assert(total == n * (n - 1) / 2);
+	
+	memcolumn_init(&ends, riv, sizeof(size_t));
+	memcolumn_init(&bytes, riv, 1);
+	for(size_t i = 0; i < 1000; i++){
+		char str[16];
+		sprintf(str, "str%d", (int)i);
+		memcolumn_append(&bytes, str, strlen(str));
+		*(size_t *)memcolumn_push(&ends) = bytes.length;
+	}
+	size_t start = memcolumn_get(&ends, size_t, 899);
+	size_t end = memcolumn_get(&ends, size_t, 900);
+	char str[16] = {0};
+	assert(!strcmp(memcolumn_copy(&bytes, start, end - start, str), "str900"));
+	
+	memcolumn_clear(&longs);
+	memcolumn_clear(&doubles);
+	memcolumn_clear(&ends);
+	memcolumn_clear(&bytes);
+	memriver_free(riv);
+}
+
+/* Check that a split pool keeps each field in an array of its own. */
+static void checkMemsoa(void){
+	size_t fields[] = {sizeof(float) * 3, sizeof(float) * 3, 200};
+	memsoa_s * soa = memsoa_make(100, 3, fields);
+	size_t n = 250;
+	
+	assert(soa->pool.bathSize == 112);
+	for(size_t i = 0; i < n; i++){
+		assert(memsoa_alloc(soa) == i);
+		float * pos = memsoa_field(soa, i, 0);
+		float * vel = memsoa_field(soa, i, 1);
+		pos[0] = pos[1] = pos[2] = 0;
+		vel[0] = vel[1] = vel[2] = i;
+	}
+	assert(memsoa_release(soa, 7) && !memsoa_used(soa, 7) && memsoa_used(soa, 8));
+	assert(!memsoa_release(soa, 7) && memsoa_alloc(soa) == 7);
+	
+	for(size_t b = 0; b < soa->pool.length; b++){
+		float (* pos)[3] = memsoa_array(soa, b, 0);
+		float (* vel)[3] = memsoa_array(soa, b, 1);
+		for(size_t i = 0; i < soa->pool.bathSize; i++){
+			pos[i][0] += vel[i][0];
+		}
+	}
+	assert(*(float *)memsoa_field(soa, 200, 0) == 200);
+	
+	memsoa_free(soa);
+}
+
+/* Check that a slot map stays dense and catches stale handles. */
+static void checkMemslots(void){
+	memslots_s * sm = memslots_make(sizeof(int));
+	uint64_t handles[100];
+	
+	for(int i = 0; i < 100; i++){
+		*(int *)memslots_alloc(sm, handles + i) = i;
+	}
+	assert(memslots_release(sm, handles[10]));
+	assert(!memslots_release(sm, handles[10]) && !memslots_get(sm, handles[10]));
+	assert(sm->length == 99 && memslots_data(sm, int)[10] == 99);
+	assert(*(int *)memslots_get(sm, handles[99]) == 99);
+	
+	uint64_t handle;
+	memslots_alloc(sm, &handle);
+	assert((uint32_t)handle == (uint32_t)handles[10] && handle != handles[10]);
+	
+	memslots_reset(sm);
+	assert(!sm->length && !memslots_get(sm, handles[0]));
+	memslots_free(sm);
+}
+
+/* Check that handles to released items are detected. */
+static void checkMempoolHandles(void){
+	mempool_s * pool = mempool_make(16, sizeof(int));
+	memhandle_t handles[40];
+	
+	for(int i = 0; i < 40; i++){
+		*(int *)mempool_alloc_handle(pool, handles + i) = i;
+	}
+	assert(*(int *)mempool_deref(pool, handles[33]) == 33);
+	assert(mempool_release_handle(pool, handles[33]));
+	assert(!mempool_deref(pool, handles[33]));
+	assert(!mempool_release_handle(pool, handles[33]));
+	
+	memhandle_t handle;
+	int * item = mempool_alloc_handle(pool, &handle);
+	assert(item == mempool_deref(pool, handle) && handle != handles[33]);
+	assert(mempool_release(pool, item) && !mempool_deref(pool, handle));
+	
+	mempool_recycle(pool);
+	assert(!mempool_deref(pool, handles[0]) && !mempool_deref(pool, MEMHANDLE_NONE));
+	mempool_free(pool);
+}
+
+/* Point the moved entry of the int * array ctx to its new location. */
+static void relocateItem(void * ctx, void * from, void * to, size_t size){
+	int ** items = ctx;
+	(void)size;
+	items[*(int *)from] = to;
+}
+
+/* Check that compacting a pool empties its last baths into the earlier ones,
+ * keeping pinned items and the handles of items that didn't move. */
+static void checkMempoolCompact(void){
+	mempool_s * pool = mempool_make(16, sizeof(int));
+	int * items[64];
+	
+	for(int i = 0; i < 64; i++){
+		items[i] = mempool_alloc(pool);
+		*items[i] = i;
+	}
+	for(int i = 0; i < 64; i++){
+		if(i % 4){
+			mempool_release(pool, items[i]);
+		}
+	}
+	int * pinned = items[4];
+	assert(mempool_pin(pool, pinned) && !mempool_pin(pool, items[5]));
+	
+	assert(mempool_compact(pool, relocateItem, items));
+	assert(pool->length == 1 && items[4] == pinned && items[60] != NULL);
+	for(int i = 0; i < 64; i += 4){
+		assert(*items[i] == i && mempool_index(pool, items[i]) != MEMPOOL_NONE);
+	}
+	
+	assert(mempool_unpin(pool, pinned) && mempool_release(pool, pinned));
+	assert(mempool_alloc(pool) == pinned);
+	mempool_free(pool);
+	
+	// 3 baths of 4, the middle one with 1 item left
+	pool = mempool_make(4, sizeof(int));
+	memhandle_t handles[12];
+	for(int i = 0; i < 12; i++){
+		items[i] = mempool_alloc_handle(pool, handles + i);
+		*items[i] = i;
+	}
+	for(int i = 0; i < 7; i++){
+		if(i != 1){
+			mempool_release_handle(pool, handles[i]);
+		}
+	}
+	
+	assert(mempool_compact(pool, relocateItem, items) && pool->length == 2);
+	assert(mempool_deref(pool, handles[1]) == items[1] && *items[1] == 1);
+	assert(mempool_deref(pool, handles[7]) == items[7] && *items[7] == 7);
+	for(int i = 8; i < 12; i++){
+		assert(!mempool_deref(pool, handles[i]) && *items[i] == i);
+	}
+	
+	// and stay stale once the pool grows back
+	memhandle_t handle;
+	for(int i = 0; i < 6; i++){
+		assert(mempool_alloc_handle(pool, &handle));
+	}
+	assert(pool->length == 3);
+	for(int i = 8; i < 12; i++){
+		assert(!mempool_deref(pool, handles[i]));
+	}
+	mempool_free(pool);
+	
+	// a pin in the last bath keeps it, but the baths before are still emptied
+	pool = mempool_make(16, sizeof(int));
+	for(int i = 0; i < 64; i++){
+		items[i] = mempool_alloc(pool);
+		*items[i] = i;
+	}
+	for(int i = 0; i < 64; i++){
+		if(i % 4){
+			mempool_release(pool, items[i]);
+		}
+	}
+	pinned = items[60];
+	assert(mempool_pin(pool, pinned));
+	
+	assert(mempool_compact(pool, relocateItem, items) && pool->length == 4);
+	assert(pool->baths[0].length == 12 && pool->baths[3].length == 4);
+	assert(!pool->baths[1].data && !pool->baths[2].data && items[60] == pinned);
+	for(int i = 0; i < 64; i += 4){
+		assert(*items[i] == i && mempool_index(pool, items[i]) != MEMPOOL_NONE);
+	}
+	
+	// the freed baths get their slots back when needed
+	size_t index;
+	for(int i = 0; i < 5; i++){
+		assert(mempool_alloc_index(pool, &index));
+	}
+	assert(index == 16 && pool->baths[1].data);
+	mempool_free(pool);
+}
+
+/* Point the entries of the char * array ctx that were in [from, from + size)
+ * to their new location. */
+static void relocateStrings(void * ctx, void * from, void * to, size_t size){
+	char ** strs = ctx;
+	for(int i = 0; i < 32; i++){
+		if(strs[i] >= (char *)from && strs[i] < (char *)from + size){
+			strs[i] = (char *)to + (strs[i] - (char *)from);
+		}
+	}
+}
+
+/* Check that flattening moves all creeks into one and reports where. */
+static void checkMemriverFlatten(void){
+	memriver_s * riv = memriver_make(64);
+	char * strs[32];
+	
+	for(int i = 0; i < 32; i++){
+		strs[i] = memriver_printf(riv, "string %i", i);
+	}
+	assert(riv->length > 1);
+	
+	char * block = memriver_flatten(riv, relocateStrings, strs)->creeks->data;
+	assert(riv->length == 1 && riv->capacity == 1);
+	for(int i = 0; i < 32; i++){
+		char str[16];
+		sprintf(str, "string %i", i);
+		assert(strs[i] >= block && strs[i] < block + riv->creeks->length);
+		assert(strcmp(strs[i], str) == 0);
+	}
+	
+	assert(memriver_alloc(riv, 64));
+	memriver_free(riv);
+}
+
+/* Check that a sweep releases exactly the unmarked items. */
+static void checkMempoolSweep(void){
+	mempool_s * pool = mempool_make(40, sizeof(int));
+	int * items[100];
+	memhandle_t handle;
+	
+	for(int i = 0; i < 100; i++){
+		items[i] = mempool_alloc(pool);
+		*items[i] = i;
+	}
+	int * kept = mempool_alloc_handle(pool, &handle);
+	
+	for(int i = 0; i < 100; i += 2){
+		assert(mempool_mark_index(pool, i));
+	}
+	assert(mempool_mark(pool, kept) && !mempool_mark_index(pool, 101));
+	
+	mempool_sweep(pool);
+	assert(pool->baths[0].length == 20 && pool->baths[2].length == 11);
+	assert(mempool_deref(pool, handle) == kept && *items[98] == 98);
+	assert(mempool_alloc(pool) == items[1]);
+	
+	// a mark goes with the released item, not with its slot
+	assert(mempool_mark(pool, items[1]) && mempool_release(pool, items[1]));
+	assert(mempool_alloc(pool) == items[1]);
+	
+	// unmarked since the last sweep
+	mempool_sweep(pool);
+	assert(!mempool_deref(pool, handle) && pool->baths[0].length == 0);
+	mempool_free(pool);
+	
+	// marks move with the items when the pool is compacted before the sweep
+	pool = mempool_make(4, sizeof(int));
+	for(int i = 0; i < 12; i++){
+		items[i] = mempool_alloc(pool);
+		*items[i] = i;
+	}
+	for(int i = 0; i < 8; i++){
+		mempool_release(pool, items[i]);
+	}
+	for(int i = 8; i < 12; i++){
+		assert(mempool_mark(pool, items[i]));
+	}
+	
+	assert(mempool_compact(pool, relocateItem, items) && pool->length == 1);
+	mempool_sweep(pool);
+	assert(pool->baths[0].length == 4);
+	for(int i = 8; i < 12; i++){
+		assert(*items[i] == i && mempool_index(pool, items[i]) != MEMPOOL_NONE);
+	}
+	mempool_free(pool);
+}
+
+/* Check that a cycle keeps the promoted objects and drops the rest. */
+static void checkMemgen(void){
+	memgen_s * gen = memgen_make(64, 64);
+	char * kept = NULL, * gone = NULL;
+	
+	for(int i = 0; i < 20; i++){
+		char * str = memgen_alloc(gen, 16);
+		sprintf(str, "request %i", i);
+		if(i == 7){
+			kept = str;
+			assert(memgen_keep(gen, (void **)&kept, 16));
+		}
+		if(i == 8){
+			assert(memgen_keep(gen, (void **)&gone, 16));
+		}
+	}
+	char * promoted = memgen_promote(gen, kept, 16);
+	assert(gen->nursery.length > 1 && gen->old.length == 1);
+	
+	char * old = kept;
+	assert(memgen_cycle(gen) && kept != old && !gone);
+	assert(strcmp(kept, "request 7") == 0 && strcmp(promoted, "request 7") == 0);
+	assert(gen->nursery.length == 1 && gen->nursery.creeks->length == 0);
+	assert(!gen->survivors && memgen_cycle(gen));
+	memgen_free(gen);
+}
+
+/* Check that creeks whose items are all released are reclaimed. */
+static void checkMemriverRelease(void){
+	memriver_s * riv = memriver_make(64);
+	char * items[12];
+	
+	for(int i = 0; i < 12; i++){
+		items[i] = memriver_alloc(riv, 16);
+		sprintf(items[i], "item %i", i);
+	}
+	assert(riv->length == 3);
+	
+	for(int i = 4; i < 7; i++){
+		assert(memriver_release(riv, items[i]) && riv->creeks[1].length == 64);
+	}
+	assert(memriver_release(riv, items[7]) && riv->creeks[1].length == 0);
+	assert(riv->length == 3 && strcmp(items[8], "item 8") == 0);
+	assert(memriver_alloc(riv, 16) == items[4] && riv->length == 3);
+	
+	// moving an item releases the old one
+	char * moved = memriver_realloc(riv, items[0], 16, 32);
+	assert(moved != items[0] && strcmp(moved, "item 0") == 0);
+	assert(riv->creeks->count == 3);
+	
+	char * big = memriver_alloc(riv, 100);
+	assert(riv->lakes && memriver_release(riv, big + 50) && !riv->lakes);
+	assert(!memriver_release(riv, &riv));
+	memriver_free(riv);
+	
+	// a reclaimed creek keeps its index, so rolling back to a mark still works
+	riv = memriver_make(64);
+	for(int i = 0; i < 6; i++){
+		items[i] = memriver_alloc(riv, 16);
+	}
+	memmark_s mark = memriver_mark(riv);
+	for(int i = 0; i < 4; i++){
+		assert(memriver_release(riv, items[i]));
+	}
+	char * after = memriver_alloc(riv, 16);
+	assert(after == items[5] + 16 && riv->length == 2);
+	assert(memriver_rollback(riv, mark, 0) && memriver_alloc(riv, 16) == after);
+	memriver_free(riv);
+}
+
+/* The digits of the cleanups that were run, in order. */
+static char cleanups[16];
+
+/* Append the digit arg points to to cleanups. */
+static void cleanup(void * arg){
+	size_t len = strlen(cleanups);
+	cleanups[len] = *(char *)arg;
+	cleanups[len + 1] = '\0';
+}
+
+/* Check that deferred cleanups run in reverse, on rollback and reset. */
+static void checkMemriverDefer(void){
+	memriver_s * riv = memriver_make(32);
+	
+	cleanups[0] = '\0';
+	assert(memriver_defer(riv, cleanup, memriver_strdup(riv, "1")));
+	memmark_s mark = memriver_mark(riv);
+	assert(memriver_defer(riv, cleanup, memriver_strdup(riv, "2")));
+	assert(memriver_defer(riv, cleanup, memriver_strdup(riv, "3")));
+	memriver_rollback(riv, mark, 0);
+	assert(strcmp(cleanups, "32") == 0);
+	
+	memriver_reset(riv);
+	assert(strcmp(cleanups, "321") == 0 && !riv->defers);
+	
+	// deferrals survive being moved
+	for(int i = 4; i < 8; i++){
+		char digit[2] = {'0' + i, '\0'};
+		assert(memriver_defer(riv, cleanup, memriver_strdup(riv, digit)));
+	}
+	assert(riv->length > 1 && memriver_flatten(riv, NULL, NULL));
+	memriver_free(riv);
+	assert(strcmp(cleanups, "3217654") == 0);
+}
+
+/* Check that scratch items fill creeks from the end and reset apart. */
+static void checkMemriverScratch(void){
+	memriver_s * riv = memriver_make(64);
+	
+	char * kept = memriver_strdup(riv, "kept");
+	char * scratch = memriver_alloc_scratch(riv, 16);
+	assert(scratch == riv->creeks->data + 48);
+	assert(memriver_alloc(riv, 28) && memriver_alloc_scratch(riv, 15));
+	assert(riv->length == 1 && riv->creeks->length + riv->creeks->scratch == 64);
+	
+	char * big = memriver_alloc_scratch(riv, 100);
+	assert(big && !riv->lakes && riv->scratchLakes);
+	assert(memriver_alloc(riv, 1) && riv->length == 2);
+	
+	memriver_reset_scratch(riv);
+	assert(!riv->scratchLakes && riv->creeks->scratch == 0);
+	assert(memriver_alloc_scratch(riv, 63) && riv->length == 2);
+	assert(memriver_alloc_scratch(riv, 31) == kept + 33 && riv->length == 2);
+	assert(strcmp(kept, "kept") == 0);
+	memriver_free(riv);
+}
+
+/* Check that a ring releases its records in order, over many wraps. */
+static void checkMemring(void){
+	memring_s * ring = memring_make(256);
+	size_t size;
+	int next = 0, oldest = 0;
+	
+	assert(!memring_oldest(ring, NULL) && !memring_release(ring));
+	assert(!memring_alloc(ring, 256 - MEMRING_ALIGN + 1));
+	
+	// records of 1 to 40 bytes, filled with their number; release the oldest
+	// when the ring is full
+	while(next < 1000){
+		size_t len = next % 40 + 1;
+		char * rec = memring_alloc(ring, len);
+		if(!rec){
+			assert(ring->length > 0);
+			
+			char * old = memring_oldest(ring, &size);
+			assert(size == (size_t)oldest % 40 + 1);
+			for(size_t i = 0; i < size; i++){
+				assert(old[i] == (char)oldest);
+			}
+			
+			memring_release(ring);
+			oldest++;
+			continue;
+		}
+		
+		assert(((uintptr_t)rec & (MEMRING_ALIGN - 1)) == 0);
+		memset(rec, (char)next, len);
+		next++;
+	}
+	assert(ring->length == (size_t)(next - oldest));
+	
+	memring_free(ring);
+}
+
+/* Check that a slab picks the right class and finds it on release. */
+static void checkMemslab(void){
+	memslab_s * slab = memslab_make();
+	void * items[64];
+	
+	assert(memslab_size(1) == 16 && memslab_size(128) == 128);
+	assert(memslab_size(129) == 160 && memslab_size(257) == 320);
+	assert(memslab_size(4096) == 4096 && memslab_size(4097) == 4097);
+	
+	for(size_t i = 0; i < 64; i++){
+		items[i] = memslab_alloc(slab, i * 100 + 1);
+		assert(items[i] && ((uintptr_t)items[i] & 15) == 0);
+		memset(items[i], (int)i, i * 100 + 1);
+	}
+	assert(slab->large && slab->pools[0] && slab->pools[27]);
+	assert(((char *)items[63])[6300] == 63 && ((char *)items[1])[100] == 1);
+	
+	for(size_t i = 0; i < 64; i += 2){
+		assert(memslab_release(slab, items[i], i * 100 + 1));
+	}
+	for(size_t i = 1; i < 64; i += 2){
+		assert(memslab_release(slab, items[i], 0));
+	}
+	assert(!slab->large && !memslab_release(slab, items[1], 0));
+	assert(memslab_alloc(slab, 101) == items[1]);
+	memslab_free(slab);
+}
+
+/* Check that TLSF items don't overlap and merge back when released. */
+static void checkMemtlsf(void){
+	memtlsf_s * tlsf = memtlsf_make(1 << 16);
+	unsigned char * items[256] = {NULL};
+	size_t sizes[256];
+	
+	// allocate and release at random, checking that no item overwrites another
+	for(int round = 0; round < 10000; round++){
+		int i = rand() % 256;
+		if(items[i]){
+			for(size_t j = 0; j < sizes[i]; j++){
+				assert(items[i][j] == (unsigned char)i);
+			}
+			memtlsf_release(tlsf, items[i]);
+			items[i] = NULL;
+		}else{
+			sizes[i] = rand() % (rand() % 8 ? 256 : 4096) + 1;
+			items[i] = memtlsf_alloc(tlsf, sizes[i]);
+			assert(items[i] && ((uintptr_t)items[i] & (MEMTLSF_ALIGN - 1)) == 0);
+			assert(memtlsf_size(items[i]) >= sizes[i]);
+			memset(items[i], i, sizes[i]);
+		}
+	}
+	for(int i = 0; i < 256; i++){
+		memtlsf_release(tlsf, items[i]);
+	}
+	
+	// everything merged back into whole regions
+	size_t regions = tlsf->river.length;
+	assert(memtlsf_alloc(tlsf, 1 << 15) && tlsf->river.length == regions);
+	
+	void * big = memtlsf_alloc(tlsf, 1 << 20);
+	assert(big && memtlsf_size(big) >= 1 << 20 && tlsf->river.lakes);
+	memtlsf_release(tlsf, big);
+	memtlsf_free(tlsf);
+	
+	// sizes between class boundaries, just below the region size and above it,
+	// get a region once and reuse it after release
+	tlsf = memtlsf_make(1 << 16);
+	size_t odd[] = {(1 << 16) - 100, (1 << 16) - 32, (1 << 16) + 100, 100000};
+	for(size_t i = 0; i < sizeof odd / sizeof *odd; i++){
+		void * item = memtlsf_alloc(tlsf, odd[i]);
+		assert(item && memtlsf_size(item) >= odd[i]);
+		memset(item, 42, odd[i]);
+		memtlsf_release(tlsf, item);
+		
+		regions = tlsf->river.length;
+		memlake_s * lakes = tlsf->river.lakes;
+		assert(memtlsf_alloc(tlsf, odd[i]) == item);
+		assert(tlsf->river.length == regions && tlsf->river.lakes == lakes);
+		memtlsf_release(tlsf, item);
+	}
+	memtlsf_free(tlsf);
+}
+
 int main(int argc, char ** argv){
 	unsigned int mult = 2, div = 4;
 	int doRelease = 1, doReuse = 1;
@@ -160,6 +1037,34 @@ int main(int argc, char ** argv){
 	
 	srand(time(NULL));
 	
+	checkMemriverLakes();
+	checkMemriverRealloc();
+	checkMemriverRollback();
+	checkRecycle();
+	checkMemriverAdapt();
+	checkMemriverStrings();
+	checkMemvec();
+	checkMemmap();
+	checkMemmapChurn();
+	checkMemintern();
+	checkMemlru();
+	checkMemlruChurn();
+	checkMemqueue();
+	checkMemcolumn();
+	checkMemsoa();
+	checkMemslots();
+	checkMempoolHandles();
+	checkMempoolCompact();
+	checkMemriverFlatten();
+	checkMempoolSweep();
+	checkMemgen();
+	checkMemriverRelease();
+	checkMemriverDefer();
+	checkMemriverScratch();
+	checkMemring();
+	checkMemslab();
+	checkMemtlsf();
+	
 	/* Malloc/free */
 	start = clock();
 	for(i = 0; i < m; i++){